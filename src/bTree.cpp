@@ -0,0 +1,297 @@
+#include "global.h"
+
+/**
+ * @brief Construct a handle on the B+ tree stored under indexName. Nothing is
+ * read until the tree is used.
+ *
+ * @param indexName
+ */
+BTree::BTree(string indexName)
+{
+    logger.log("BTree::BTree");
+    this->indexName = indexName;
+}
+
+/**
+ * @brief Number of entries of entryWidth ints that fit in a leaf besides its
+ * header.
+ *
+ * @return uint
+ */
+uint BTree::leafCapacity()
+{
+    return (uint)((BLOCK_SIZE * 1000) / (sizeof(int) * this->entryWidth)) - 1;
+}
+
+/**
+ * @brief Number of {key, child} entries that fit in an internal node besides
+ * its header.
+ *
+ * @return uint
+ */
+uint BTree::internalCapacity()
+{
+    return (uint)((BLOCK_SIZE * 1000) / (sizeof(int) * 2)) - 1;
+}
+
+void BTree::readMeta()
+{
+    logger.log("BTree::readMeta");
+    vector<int> meta = bufferManager.getIndexPage(this->indexName, 0).rows[0];
+    this->root = meta[0];
+    this->height = meta[1];
+    this->pageCount = meta[2];
+    // trees written before included columns have no width
+    this->entryWidth = meta.size() > 3 ? meta[3] : 3;
+}
+
+void BTree::writeMeta()
+{
+    logger.log("BTree::writeMeta");
+    vector<vector<int>> meta = {{(int)this->root, (int)this->height, (int)this->pageCount,
+                                 (int)this->entryWidth}};
+    bufferManager.writeIndexPage(this->indexName, 0, meta);
+}
+
+/**
+ * @brief Builds the tree from entries, a table of rows {key, page, slot,
+ * included values...} sorted on key. The entries are read once. Only the rightmost node of every
+ * level is kept in memory: when a node is full it is written out, a new node
+ * is started and the first key of the new node is added to the level above,
+ * which is created when its level splits for the first time. A page is
+ * given to a node when it is started, so a leaf already knows the page of
+ * the leaf that follows when it is written.
+ *
+ * @param entries
+ */
+void BTree::bulkLoad(Table *entries)
+{
+    logger.log("BTree::bulkLoad");
+    this->pageCount = 1;
+    this->entryWidth = entries->columnCount;
+    // the node being filled on every level, leaves first, and its page
+    vector<vector<vector<int>>> levels = {{{1, -1}}};
+    vector<int> levelPages = {(int)this->pageCount++};
+    function<void(uint, vector<int>)> addEntry = [&](uint level, vector<int> entry) {
+        uint capacity = level ? this->internalCapacity() : this->leafCapacity();
+        if (levels[level].size() - 1 < capacity)
+        {
+            levels[level].push_back(entry);
+            return;
+        }
+        int fullPage = levelPages[level];
+        int newPage = this->pageCount++;
+        if (level == 0)
+            levels[level][0][1] = newPage;
+        bufferManager.writeIndexPage(this->indexName, fullPage, levels[level]);
+        levelPages[level] = newPage;
+        if (level == 0)
+            levels[level] = {{1, -1}, entry};
+        else
+            levels[level] = {{0, entry[1]}};
+        if (level + 1 == levels.size())
+        {
+            levels.push_back({{0, fullPage}});
+            levelPages.push_back(this->pageCount++);
+        }
+        addEntry(level + 1, {entry[0], newPage});
+    };
+
+    for (int pageCounter = 0; pageCounter < entries->blockCount; pageCounter++)
+    {
+        vector<vector<int>> rows = entries->readPage(pageCounter);
+        for (vector<int> &row : rows)
+            addEntry(0, row);
+    }
+    for (uint level = 0; level < levels.size(); level++)
+        bufferManager.writeIndexPage(this->indexName, levelPages[level], levels[level]);
+    this->root = levelPages.back();
+    this->height = levels.size();
+    this->writeMeta();
+    logger.log("BTree::bulkLoad: " + to_string(this->pageCount) + " pages, height " +
+               to_string(this->height));
+}
+
+/**
+ * @brief Returns the page of the leftmost leaf that may hold key. In an
+ * internal node the last child whose smallest key is below key is followed,
+ * as the entries for key may start at the end of that child when key is also
+ * the smallest key of the next one.
+ *
+ * @param key
+ * @return uint
+ */
+uint BTree::findLeaf(long long key)
+{
+    logger.log("BTree::findLeaf");
+    this->readMeta();
+    uint page = this->root;
+    for (uint level = 1; level < this->height; level++)
+    {
+        vector<vector<int>> node = bufferManager.getIndexPage(this->indexName, page).rows;
+        page = node[0][1];
+        for (int entryCounter = 1; entryCounter < node.size() && node[entryCounter][0] < key;
+             entryCounter++)
+            page = node[entryCounter][1];
+    }
+    return page;
+}
+
+/**
+ * @brief Returns the position, counting from 0 in key order, of the leaf that
+ * findLeaf gives for key. Every node but the last of each level is full, so a
+ * node with n children before it in its parent that sits at position p on its
+ * level is at position p * (internalCapacity() + 1) + n on the level below.
+ *
+ * @param key
+ * @return long long
+ */
+long long BTree::leafOrdinal(long long key)
+{
+    logger.log("BTree::leafOrdinal");
+    this->readMeta();
+    uint page = this->root;
+    long long ordinal = 0;
+    for (uint level = 1; level < this->height; level++)
+    {
+        vector<vector<int>> node = bufferManager.getIndexPage(this->indexName, page).rows;
+        page = node[0][1];
+        int child = 0;
+        for (int entryCounter = 1; entryCounter < node.size() && node[entryCounter][0] < key;
+             entryCounter++)
+        {
+            page = node[entryCounter][1];
+            child = entryCounter;
+        }
+        ordinal = ordinal * (this->internalCapacity() + 1) + child;
+    }
+    return ordinal;
+}
+
+/**
+ * @brief Returns the number of leaves scanRange reads for [lowKey, highKey],
+ * found from the internal nodes on the paths to both ends of the range
+ * without reading any leaf.
+ *
+ * @param lowKey
+ * @param highKey
+ * @return long long
+ */
+long long BTree::rangeLeafCount(long long lowKey, long long highKey)
+{
+    logger.log("BTree::rangeLeafCount");
+    if (lowKey > highKey)
+        return 0;
+    return this->leafOrdinal(highKey + 1) - this->leafOrdinal(lowKey) + 1;
+}
+
+/**
+ * @brief Returns the location {page, slot} of every row whose key is key, in
+ * the order of the rows in the table.
+ *
+ * @param key
+ * @return vector<pair<int, int>>
+ */
+vector<pair<int, int>> BTree::find(int key)
+{
+    logger.log("BTree::find");
+    return this->findRange(key, key);
+}
+
+/**
+ * @brief Returns the location {page, slot} of every row whose key lies in
+ * [lowKey, highKey], in key order and then in the order of the rows in the
+ * table. The leaf holding lowKey is found from the root and the leaf chain is
+ * followed until a key above highKey is met.
+ *
+ * @param lowKey
+ * @param highKey
+ * @return vector<pair<int, int>>
+ */
+vector<pair<int, int>> BTree::findRange(long long lowKey, long long highKey)
+{
+    logger.log("BTree::findRange");
+    vector<pair<int, int>> locations;
+    this->scanRange(lowKey, highKey, [&](vector<int> &entry) {
+        locations.emplace_back(entry[1], entry[2]);
+    });
+    return locations;
+}
+
+/**
+ * @brief Calls visit on every leaf entry {key, page, slot, included
+ * values...} whose key lies in [lowKey, highKey], in key order and then in
+ * the order of the rows in the table. Only the leaves holding such keys are
+ * read, one at a time.
+ *
+ * @param lowKey
+ * @param highKey
+ * @param visit
+ */
+void BTree::scanRange(long long lowKey, long long highKey, const function<void(vector<int> &)> &visit)
+{
+    logger.log("BTree::scanRange");
+    if (lowKey > highKey)
+        return;
+    int page = this->findLeaf(lowKey);
+    while (page != -1)
+    {
+        vector<vector<int>> leaf = bufferManager.getIndexPage(this->indexName, page).rows;
+        for (int entryCounter = 1; entryCounter < leaf.size(); entryCounter++)
+        {
+            vector<int> &entry = leaf[entryCounter];
+            if (entry[0] > highKey)
+                return;
+            if (entry[0] >= lowKey)
+                visit(entry);
+        }
+        page = leaf[0][1];
+    }
+}
+
+/**
+ * @brief Returns the locations {page, slot} of the rows of every key of keys,
+ * which must be sorted and distinct. The keys are looked up in order, so the
+ * leaves are visited from left to right: a key is searched in the leaf where
+ * the previous key ended as long as that leaf reaches it, and the tree is
+ * only descended again for a key beyond the leaf.
+ *
+ * @param keys
+ * @return vector<vector<pair<int, int>>> locations of keys[i] at i
+ */
+vector<vector<pair<int, int>>> BTree::findKeys(const vector<int> &keys)
+{
+    logger.log("BTree::findKeys");
+    vector<vector<pair<int, int>>> locations(keys.size());
+    vector<vector<int>> leaf;
+    for (int keyCounter = 0; keyCounter < keys.size(); keyCounter++)
+    {
+        int key = keys[keyCounter];
+        if (leaf.size() <= 1 || leaf.back()[0] < key)
+            leaf = bufferManager.getIndexPage(this->indexName, this->findLeaf(key)).rows;
+        int entryCounter = lower_bound(leaf.begin() + 1, leaf.end(), key,
+                                       [](const vector<int> &entry, int key) { return entry[0] < key; }) -
+                           leaf.begin();
+        while (true)
+        {
+            for (; entryCounter < leaf.size() && leaf[entryCounter][0] == key; entryCounter++)
+                locations[keyCounter].emplace_back(leaf[entryCounter][1], leaf[entryCounter][2]);
+            if (entryCounter < leaf.size() || leaf[0][1] == -1)
+                break;
+            leaf = bufferManager.getIndexPage(this->indexName, leaf[0][1]).rows;
+            entryCounter = 1;
+        }
+    }
+    return locations;
+}
+
+/**
+ * @brief Deletes every page of the tree.
+ */
+void BTree::drop()
+{
+    logger.log("BTree::drop");
+    this->readMeta();
+    for (uint pageCounter = 0; pageCounter < this->pageCount; pageCounter++)
+        bufferManager.deleteIndexFile(this->indexName, pageCounter);
+}
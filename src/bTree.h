@@ -0,0 +1,53 @@
+#include "hashTable.h"
+
+class Table;
+
+/**
+ * @brief The BTree is a B+ tree index on one column of a table, kept entirely
+ * on disk: every node is an IndexPage read and written through the buffer
+ * manager, and the BTree object is only a handle that knows the name of the
+ * index. Page 0 holds the root, the height, the number of pages of the tree
+ * and the width of a leaf entry.
+ *
+ * <p>
+ * The first row of a node is its header, {1, next leaf} for a leaf and
+ * {0, first child} for an internal node. A leaf then holds one row
+ * {key, page, slot, included values...} per row of the table, locating the
+ * row by the page it is in and its position in that page and carrying the
+ * values of the included columns, if any, so that queries needing only those
+ * columns and the key can be answered from the leaves. An internal node holds
+ * rows
+ * {key, child} where key is the smallest key under child. Leaves are chained
+ * in key order so that a range is read by following the chain.
+ * </p>
+ *
+ * <p>
+ * The tree is bulk loaded from entries sorted on key, filling the nodes from
+ * left to right, so every node but the last of each level is full.
+ * </p>
+ */
+class BTree
+{
+    string indexName;
+    uint root = 0;
+    uint height = 0;
+    uint pageCount = 0;
+    uint entryWidth = 3;
+
+    uint leafCapacity();
+    uint internalCapacity();
+    void readMeta();
+    void writeMeta();
+    uint findLeaf(long long key);
+    long long leafOrdinal(long long key);
+
+public:
+    BTree(string indexName);
+    void bulkLoad(Table *entries);
+    vector<pair<int, int>> find(int key);
+    vector<pair<int, int>> findRange(long long lowKey, long long highKey);
+    void scanRange(long long lowKey, long long highKey, const function<void(vector<int> &)> &visit);
+    long long rangeLeafCount(long long lowKey, long long highKey);
+    vector<vector<pair<int, int>>> findKeys(const vector<int> &keys);
+    void drop();
+};
@@ -0,0 +1,140 @@
+#include "global.h"
+
+/**
+ * @brief Construct a handle on the bitmap index stored under indexName.
+ * Nothing is read until the index is used.
+ *
+ * @param indexName
+ */
+BitmapIndex::BitmapIndex(string indexName)
+{
+    logger.log("BitmapIndex::BitmapIndex");
+    this->indexName = indexName;
+}
+
+/**
+ * @brief Number of {value, first page, ints} rows in a directory page.
+ *
+ * @return uint
+ */
+uint BitmapIndex::directoryCapacity()
+{
+    return (uint)((BLOCK_SIZE * 1000) / (sizeof(int) * 3));
+}
+
+/**
+ * @brief Number of ints of a serialized bitmap in a page.
+ *
+ * @return uint
+ */
+uint BitmapIndex::pageCapacity()
+{
+    return (uint)((BLOCK_SIZE * 1000) / sizeof(int));
+}
+
+void BitmapIndex::readMeta()
+{
+    logger.log("BitmapIndex::readMeta");
+    vector<int> meta = bufferManager.getIndexPage(this->indexName, 0).rows[0];
+    this->valueCount = meta[0];
+    this->directoryPageCount = meta[1];
+    this->pageCount = meta[2];
+}
+
+void BitmapIndex::writeMeta()
+{
+    logger.log("BitmapIndex::writeMeta");
+    vector<vector<int>> meta = {{(int)this->valueCount, (int)this->directoryPageCount,
+                                 (int)this->pageCount}};
+    bufferManager.writeIndexPage(this->indexName, 0, meta);
+}
+
+/**
+ * @brief Builds the bitmaps of the column at columnIndex of table, reading
+ * the table once. The bitmaps of all values are kept in memory while the
+ * table is read, which a column with few distinct values allows.
+ *
+ * @param table
+ * @param columnIndex
+ */
+void BitmapIndex::build(Table *table, int columnIndex)
+{
+    logger.log("BitmapIndex::build");
+    map<int, RoaringBitmap> bitmaps;
+    uint rowNumber = 0;
+    for (int pageCounter = 0; pageCounter < table->blockCount; pageCounter++)
+    {
+        vector<vector<int>> rows = table->readPage(pageCounter);
+        for (vector<int> &row : rows)
+            bitmaps[row[columnIndex]].add(rowNumber++);
+    }
+
+    this->valueCount = bitmaps.size();
+    this->directoryPageCount = (this->valueCount + this->directoryCapacity() - 1) / this->directoryCapacity();
+    this->pageCount = 1 + this->directoryPageCount;
+    vector<vector<int>> directory;
+    for (auto &valueBitmap : bitmaps)
+    {
+        valueBitmap.second.optimize();
+        vector<int> ints = valueBitmap.second.serialize();
+        directory.push_back({valueBitmap.first, (int)this->pageCount, (int)ints.size()});
+        for (uint intCounter = 0; intCounter < ints.size(); intCounter += this->pageCapacity())
+        {
+            vector<vector<int>> page = {vector<int>(ints.begin() + intCounter,
+                                                    ints.begin() + min((uint)ints.size(), intCounter + this->pageCapacity()))};
+            bufferManager.writeIndexPage(this->indexName, this->pageCount++, page);
+        }
+    }
+    for (uint directoryPage = 0; directoryPage < this->directoryPageCount; directoryPage++)
+    {
+        uint first = directoryPage * this->directoryCapacity();
+        vector<vector<int>> page(directory.begin() + first,
+                                 directory.begin() + min((uint)directory.size(), first + this->directoryCapacity()));
+        bufferManager.writeIndexPage(this->indexName, 1 + directoryPage, page);
+    }
+    this->writeMeta();
+    logger.log("BitmapIndex::build: " + to_string(this->valueCount) + " values, " +
+               to_string(this->pageCount) + " pages");
+}
+
+/**
+ * @brief Returns the bitmap of the rows whose value is value, empty if there
+ * are none. The directory pages are read until the one that would hold value.
+ *
+ * @param value
+ * @return RoaringBitmap
+ */
+RoaringBitmap BitmapIndex::find(int value)
+{
+    logger.log("BitmapIndex::find");
+    this->readMeta();
+    for (uint directoryPage = 1; directoryPage <= this->directoryPageCount; directoryPage++)
+    {
+        vector<vector<int>> directory = bufferManager.getIndexPage(this->indexName, directoryPage).rows;
+        if (directory.back()[0] < value)
+            continue;
+        auto entry = lower_bound(directory.begin(), directory.end(), value,
+                                 [](const vector<int> &entry, int value) { return entry[0] < value; });
+        if ((*entry)[0] != value)
+            break;
+        vector<int> ints;
+        for (int page = (*entry)[1]; ints.size() < (*entry)[2]; page++)
+        {
+            vector<int> pageInts = bufferManager.getIndexPage(this->indexName, page).rows[0];
+            ints.insert(ints.end(), pageInts.begin(), pageInts.end());
+        }
+        return RoaringBitmap::deserialize(ints);
+    }
+    return RoaringBitmap();
+}
+
+/**
+ * @brief Deletes every page of the index.
+ */
+void BitmapIndex::drop()
+{
+    logger.log("BitmapIndex::drop");
+    this->readMeta();
+    for (uint pageCounter = 0; pageCounter < this->pageCount; pageCounter++)
+        bufferManager.deleteIndexFile(this->indexName, pageCounter);
+}
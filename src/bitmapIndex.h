@@ -0,0 +1,36 @@
+#include "roaringBitmap.h"
+
+/**
+ * @brief The BitmapIndex keeps, for every distinct value of one column of a
+ * table, the RoaringBitmap of the rows holding it, rows being numbered from 0
+ * in table order. It is meant for columns with few distinct values, where a
+ * B+ tree or hash index holds long lists of equal keys: the bitmaps of such
+ * a column are small, and equalities on several indexed columns are combined
+ * by AND and OR of their bitmaps before any page of the table is read.
+ *
+ * <p>
+ * Like the other indexes it lives in IndexPages read and written through the
+ * buffer manager. Page 0 holds {values, directory pages, pages}. Pages 1 to
+ * the number of directory pages hold rows {value, first page, ints} sorted on
+ * value, giving the pages where the serialized bitmap of value is. Every
+ * bitmap starts on a page of its own and goes on over the pages that follow.
+ * </p>
+ */
+class BitmapIndex
+{
+    string indexName;
+    uint valueCount = 0;
+    uint directoryPageCount = 0;
+    uint pageCount = 0;
+
+    uint directoryCapacity();
+    uint pageCapacity();
+    void readMeta();
+    void writeMeta();
+
+public:
+    BitmapIndex(string indexName);
+    void build(Table *table, int columnIndex);
+    RoaringBitmap find(int value);
+    void drop();
+};
@@ -0,0 +1,59 @@
+#include "global.h"
+
+BloomFilter::BloomFilter()
+{
+}
+
+/**
+ * @brief Construct an empty filter sized for keyCount keys.
+ *
+ * @param keyCount
+ */
+BloomFilter::BloomFilter(uint keyCount)
+{
+    this->words.assign(max(1u, (keyCount * BITS_PER_KEY + 63) / 64), 0);
+}
+
+uint64_t BloomFilter::hashOf(int key)
+{
+    uint64_t hash = (uint32_t)key;
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/**
+ * @brief The high 32 bits of the hash pick the word, and BIT_COUNT slices of
+ * 6 bits of the low ones pick the bits within it.
+ *
+ * @param key
+ */
+void BloomFilter::insert(int key)
+{
+    uint64_t hash = hashOf(key);
+    uint64_t &word = this->words[((hash >> 32) * this->words.size()) >> 32];
+    for (uint bitCounter = 0; bitCounter < BIT_COUNT; bitCounter++)
+        word |= 1ULL << ((hash >> (6 * bitCounter)) & 63);
+}
+
+/**
+ * @brief Returns false if key was certainly never inserted. An empty filter,
+ * one that was never sized, may contain anything.
+ *
+ * @param key
+ * @return true if key may have been inserted
+ */
+bool BloomFilter::mayContain(int key)
+{
+    if (this->words.empty())
+        return true;
+    uint64_t hash = hashOf(key);
+    uint64_t word = this->words[((hash >> 32) * this->words.size()) >> 32];
+    for (uint bitCounter = 0; bitCounter < BIT_COUNT; bitCounter++)
+        if (!(word >> ((hash >> (6 * bitCounter)) & 63) & 1))
+            return false;
+    return true;
+}
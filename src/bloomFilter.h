@@ -0,0 +1,29 @@
+#include "bitmapIndex.h"
+
+/**
+ * @brief The BloomFilter is a small in-memory set of keys that can answer
+ * "certainly not present" or "maybe present", used to keep one filter per
+ * page of a table on a chosen column so that a lookup of a key can skip the
+ * pages that do not hold it.
+ *
+ * <p>
+ * It is blocked: a key sets and tests BIT_COUNT bits of a single 64 bit word
+ * chosen by its hash, so a test touches one word. With BITS_PER_KEY bits per
+ * key a key that is not present passes a few percent of the time.
+ * </p>
+ */
+class BloomFilter
+{
+    vector<uint64_t> words;
+
+    static const uint BITS_PER_KEY = 10;
+    static const uint BIT_COUNT = 3;
+
+    static uint64_t hashOf(int key);
+
+public:
+    BloomFilter();
+    BloomFilter(uint keyCount);
+    void insert(int key);
+    bool mayContain(int key);
+};
@@ -19,10 +19,16 @@ Page BufferManager::getPage(string tableName, int pageIndex)
     logger.log("BufferManager::getPage");
     string pageName = "../data/temp/"+tableName + "_Page" + to_string(pageIndex);
     logger.log("BufferManager::getPage: " + pageName);
-    if (this->inPool(pageName))
-        return this->getFromPool(pageName);
-    else
-        return this->insertIntoPool(tableName, pageIndex);
+    {
+        lock_guard<mutex> lock(this->poolMutex);
+        if (this->inPool(pageName))
+            return this->getFromPool(pageName);
+    }
+    // the page is read without holding the pool so that threads reading
+    // different pages do not wait for each other
+    Page page(tableName, pageIndex);
+    lock_guard<mutex> lock(this->poolMutex);
+    return this->insertIntoPool(page);
 }
 
 /**
@@ -91,6 +97,7 @@ bool BufferManager::inMatrixPool(string matrixPageName)
  */
 bool BufferManager::removeFromPool(string tableName, int pageIndex)
 {
+    lock_guard<mutex> lock(this->poolMutex);
     string pageName = "../data/temp/"+tableName + "_Page" + to_string(pageIndex);
     logger.log("BufferManager::removeFromPool" + pageName);
     int N = this->pages.size();
@@ -151,18 +158,17 @@ MatrixPage BufferManager::getFromMatrixPool(string matrixPageName)
 }
 
 /**
- * @brief Inserts page indicated by tableName and pageIndex into pool. If the
+ * @brief Inserts page, just read from the disk, into pool. If the
  * pool is full, the pool ejects the oldest inserted page from the pool and adds
  * the current page at the end. It naturally follows a queue data structure. 
  *
- * @param tableName 
- * @param pageIndex 
+ * @param page 
  * @return Page 
  */
-Page BufferManager::insertIntoPool(string tableName, int pageIndex)
+Page BufferManager::insertIntoPool(Page page)
 {
+    blockReadCounter++;
     logger.log("BufferManager::insertIntoPool");
-    Page page(tableName, pageIndex);
     if (this->pages.size() >= BLOCK_COUNT)    
         pages.pop_front();
     pages.push_back(page);
@@ -203,6 +209,12 @@ MatrixPage BufferManager::insertIntoMatrixPool(string matrixName, int maxBlocksP
  */
 void BufferManager::writePage(string tableName, int pageIndex, vector<vector<int>> rows, int rowCount)
 {
+    {
+        // only the counter is shared; threads write pages of their own, so
+        // the file is written without holding the lock
+        lock_guard<mutex> lock(this->poolMutex);
+        blockWriteCounter++;
+    }
     logger.log("BufferManager::writePage");
     Page page(tableName, pageIndex, rows, rowCount);
     page.writePage();
@@ -266,3 +278,74 @@ void BufferManager::deleteMatrixFile(string matrixName, int matrixPageIndex)
     string fileName = "../data/temp/"+matrixName + "_MatrixPage" + to_string(matrixPageIndex);
     this->deleteFile(fileName);
 }
+
+/**
+ * @brief Function called to read a page of an index. If the page is not
+ * present in the index pool, it is read from the disk and inserted into the
+ * pool, ejecting the oldest page if the pool is full.
+ *
+ * @param indexName 
+ * @param pageIndex 
+ * @return IndexPage 
+ */
+IndexPage BufferManager::getIndexPage(string indexName, int pageIndex)
+{
+    logger.log("BufferManager::getIndexPage");
+    string pageName = "../data/index/" + indexName + "_IndexPage" + to_string(pageIndex);
+    {
+        lock_guard<mutex> lock(this->poolMutex);
+        for (IndexPage &page : this->indexPages)
+            if (page.pageName == pageName)
+                return page;
+    }
+    IndexPage page(indexName, pageIndex);
+    lock_guard<mutex> lock(this->poolMutex);
+    blockReadCounter++;
+    if (this->indexPages.size() >= BLOCK_COUNT)
+        this->indexPages.pop_front();
+    this->indexPages.push_back(page);
+    return page;
+}
+
+/**
+ * @brief Writes the page pageIndex of the index indexName, replacing the
+ * copy in the index pool if there is one.
+ *
+ * @param indexName 
+ * @param pageIndex 
+ * @param rows 
+ */
+void BufferManager::writeIndexPage(string indexName, int pageIndex, vector<vector<int>> rows)
+{
+    lock_guard<mutex> lock(this->poolMutex);
+    blockWriteCounter++;
+    logger.log("BufferManager::writeIndexPage");
+    IndexPage page(indexName, pageIndex, rows);
+    page.writePage();
+    for (IndexPage &pooledPage : this->indexPages)
+        if (pooledPage.pageName == page.pageName)
+            pooledPage = page;
+}
+
+/**
+ * @brief Removes the page pageIndex of the index indexName from the index
+ * pool and deletes its file.
+ *
+ * @param indexName 
+ * @param pageIndex 
+ */
+void BufferManager::deleteIndexFile(string indexName, int pageIndex)
+{
+    logger.log("BufferManager::deleteIndexFile");
+    string fileName = "../data/index/" + indexName + "_IndexPage" + to_string(pageIndex);
+    {
+        lock_guard<mutex> lock(this->poolMutex);
+        for (auto page = this->indexPages.begin(); page != this->indexPages.end(); page++)
+            if (page->pageName == fileName)
+            {
+                this->indexPages.erase(page);
+                break;
+            }
+    }
+    this->deleteFile(fileName);
+}
@@ -19,14 +19,28 @@
  * was previously present in the buffer or was read in from the disk. 
  * </p>
  *
+ * <p>
+ * Pages of tables may be read by several threads at once, so the pool of
+ * table pages is guarded by a mutex. 
+ * </p>
+ *
+ * <p>
+ * Pages of indexes are kept in a pool of their own, also of BLOCK_COUNT pages
+ * and guarded by the same mutex. They are written through: a page written
+ * while it is in the pool is replaced there as well.
+ * </p>
+ *
  */
 class BufferManager{
 
     deque<Page> pages; 
+    mutex poolMutex;
     bool inPool(string pageName);
     Page getFromPool(string pageName);
-    Page insertIntoPool(string tableName, int pageIndex);
+    Page insertIntoPool(Page page);
     
+    deque<IndexPage> indexPages;
+
     deque<MatrixPage> matrixPages; 
     bool inMatrixPool(string matrixPageName);
     MatrixPage getFromMatrixPool(string matrixPageName);
@@ -42,6 +56,10 @@ class BufferManager{
     void writePage(string tableName, int pageIndex, vector<vector<int>> rows, int rowCount);
     bool removeFromPool(string tableName, int pageIndex);
 
+    IndexPage getIndexPage(string indexName, int pageIndex);
+    void writeIndexPage(string indexName, int pageIndex, vector<vector<int>> rows);
+    void deleteIndexFile(string indexName, int pageIndex);
+
     MatrixPage getMatrixPage(string matrixName, int maxBlocksPerRow, int matrixPageIndex);
     void writeMatrixPage(string matrixPageName, vector<vector<int>> rows);
     void deleteMatrixFile(string matrixName, int matrixPageIndex);
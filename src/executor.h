@@ -31,6 +31,6 @@ void executeCOMPUTE();
 void executeORDERBY();
 void executeGROUPBY();
 
-bool evaluateBinOp(int value1, int value2, BinaryOperator binaryOperator);
+bool evaluateBinOp(long long value1, long long value2, BinaryOperator binaryOperator);
 void printRowCount(int rowCount);
 void printBlockAccess(int accessCount);
@@ -73,31 +73,14 @@ void executeCROSS()
         columns.emplace_back(columnName);
     }
 
-    Table *resultantTable = new Table(parsedQuery.crossResultRelationName, columns);\
-
-    Cursor cursor1 = table1.getCursor();
-    Cursor cursor2 = table2.getCursor();
-
-    vector<int> row1 = cursor1.getNext();
-    vector<int> row2;
-    vector<int> resultantRow;
-    resultantRow.reserve(resultantTable->columnCount);
-
-    while (!row1.empty())
-    {
-
-        cursor2 = table2.getCursor();
-        row2 = cursor2.getNext();
-        while (!row2.empty())
-        {
-            resultantRow = row1;
-            resultantRow.insert(resultantRow.end(), row2.begin(), row2.end());
-            resultantTable->writeRow<int>(resultantRow);
-            row2 = cursor2.getNext();
-        }
-        row1 = cursor1.getNext();
-    }
-    resultantTable->blockify();
+    Table *resultantTable = new Table(parsedQuery.crossResultRelationName, columns);
+    resultantTable->blockNestedLoopJoin(&table1, &table2, -1, -1, NO_BINOP_CLAUSE);
     tableCatalogue.insertTable(resultantTable);
+
+    cout<< "No. of blocks read: " << blockReadCounter << endl; 
+    cout<< "No. of blocks written: " << blockWriteCounter << endl; 
+    cout<< "No. of blocks accessed: " << blockReadCounter + blockWriteCounter << endl; 
+    blockReadCounter = 0;
+    blockWriteCounter = 0;
     return;
 }
\ No newline at end of file
@@ -39,5 +39,37 @@ bool semanticParseDISTINCT()
 void executeDISTINCT()
 {
     logger.log("executeDISTINCT");
+
+    Table* table = tableCatalogue.getTable(parsedQuery.distinctRelationName);
+    Table* resultantTable = new Table(parsedQuery.distinctResultRelationName, table->columns);
+
+    // The number of distinct rows is at most the row count and at most the
+    // product of the distinct value counts of the columns. If that bound fits
+    // in the buffer (leaving one block for the input page and one for the
+    // output) the duplicates are removed with a hash set, otherwise by sorting.
+    long long distinctRowBound = table->rowCount;
+    if (table->distinctValuesPerColumnCount.size() == table->columnCount)
+    {
+        long long product = 1;
+        for (uint distinctValues : table->distinctValuesPerColumnCount)
+        {
+            product *= distinctValues;
+            if (product >= distinctRowBound)
+                break;
+        }
+        distinctRowBound = min(distinctRowBound, product);
+    }
+    long long distinctBlockBound = (distinctRowBound + resultantTable->maxRowsPerBlock - 1) / resultantTable->maxRowsPerBlock;
+
+    // Equal rows are next to each other in a table sorted on all its columns,
+    // and are dropped as the table is read in order.
+    unordered_set<string> sortedColumns(table->sortedColumns.begin(), table->sortedColumns.end());
+    if (sortedColumns.size() == table->columnCount)
+        resultantTable->streamDistinct(table);
+    else if (distinctBlockBound <= BLOCK_COUNT - 2)
+        resultantTable->hashDistinct(table);
+    else
+        resultantTable->sortDistinct(table);
+    tableCatalogue.insertTable(resultantTable);
     return;
 }
\ No newline at end of file
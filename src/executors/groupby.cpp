@@ -1,78 +1,72 @@
 #include "global.h"
+
+/**
+ * @brief Splits an aggregate of the form FUNC(column) into the function and
+ * the column. Only MAX, MIN, SUM, COUNT and AVG are accepted.
+ *
+ * @param token
+ * @param function
+ * @param columnName
+ * @return true if token is a valid aggregate
+ */
+bool parseAggregate(string token, string &function, string &columnName)
+{
+    size_t open = token.find('(');
+    if (open == string::npos || open == 0 || token.back() != ')' || open + 2 >= token.size())
+        return false;
+    function = token.substr(0, open);
+    columnName = token.substr(open + 1, token.size() - open - 2);
+    return function == "MAX" || function == "MIN" || function == "SUM" ||
+           function == "COUNT" || function == "AVG";
+}
+
 /**
  * @brief 
- * SYNTAX: <new_table> <- GROUP BY <grouping_attribute> FROM <table_name> 
- *                          HAVING <aggregate_func(attribute)> <bin_op> <attribute_value> 
- *                          RETURN <aggregate_func(attribute)>
+ * SYNTAX: <new_table> <- GROUP BY <grouping_attribute>, ... FROM <table_name> 
+ *                          [HAVING <aggregate_func(attribute)> <bin_op> <attribute_value>] 
+ *                          RETURN <aggregate_func(attribute)>, ...
  */
 bool syntacticParseGROUPBY()
 {
     logger.log("syntacticParseGROUPBY");
-    // for(int i = 0; i < tokenizedQuery.size(); ++i) {
-    //     cout << i << "|" << tokenizedQuery[i] << endl;
-    // }
-    if (tokenizedQuery.size() != 13 || tokenizedQuery[2] != "GROUP" || tokenizedQuery[3] != "BY"
-            || tokenizedQuery[5] != "FROM" || tokenizedQuery[7] != "HAVING"|| tokenizedQuery[11] != "RETURN")
+    int fromIndex = find(tokenizedQuery.begin(), tokenizedQuery.end(), "FROM") - tokenizedQuery.begin();
+    int returnIndex = find(tokenizedQuery.begin(), tokenizedQuery.end(), "RETURN") - tokenizedQuery.begin();
+    if (tokenizedQuery.size() < 8 || tokenizedQuery[3] != "BY" || fromIndex < 5 ||
+        returnIndex >= (int)tokenizedQuery.size() - 1 ||
+        (returnIndex != fromIndex + 2 && (returnIndex != fromIndex + 6 || tokenizedQuery[fromIndex + 2] != "HAVING")))
     {
         cout << "SYNTAX ERROR" << endl;
         return false;
     }
     parsedQuery.queryType = GROUPBY;
     parsedQuery.groupbyResultRelationName = tokenizedQuery[0];
-    parsedQuery.groupbyColumnName = tokenizedQuery[4];
-    parsedQuery.groupbyRelationName = tokenizedQuery[6];
-
-    string attr1 = "", attr2 = "", func1 = "", func2 = "";
-    int i=0; 
-    while(tokenizedQuery[8][i] != '('){
-        func1.push_back(tokenizedQuery[8][i]);
-        i++;
-    }
-    i++;
-    while(tokenizedQuery[8][i] != ')'){
-        attr1.push_back(tokenizedQuery[8][i]);
-        i++;
-    }   
-    
-    i=0;
-    while(tokenizedQuery[12][i] != '('){
-        func2.push_back(tokenizedQuery[12][i]);
-        i++;
+    parsedQuery.groupbyRelationName = tokenizedQuery[fromIndex + 1];
+    for (int i = 4; i < fromIndex; i++)
+        parsedQuery.groupbyColumnNames.emplace_back(tokenizedQuery[i]);
+
+    for (int i = returnIndex + 1; i < tokenizedQuery.size(); i++)
+    {
+        string function, columnName;
+        if (!parseAggregate(tokenizedQuery[i], function, columnName))
+        {
+            cout << "SYNTAX ERROR" << endl;
+            return false;
+        }
+        parsedQuery.groupbyReturnFunctions.emplace_back(function);
+        parsedQuery.groupbyReturnColumnNames.emplace_back(columnName);
     }
-    i++;
-    while(tokenizedQuery[12][i] != ')'){
-        attr2.push_back(tokenizedQuery[12][i]);
-        i++;
-    } 
 
-    if(attr1 != attr2){
+    if (returnIndex == fromIndex + 2)
+        return true;
+
+    if (!parseAggregate(tokenizedQuery[fromIndex + 3], parsedQuery.groupbyHavingFunction,
+                        parsedQuery.groupbyHavingColumnName))
+    {
         cout << "SYNTAX ERROR" << endl;
         return false;
     }
 
-    parsedQuery.groupbyGroupingColumnName = attr1;
-    parsedQuery.groupbyAggregateFunc1 = func1;
-    parsedQuery.groupbyAggregateFunc2 = func2;
-
-    // bool flag = false;
-    // for(char &ch: tokenizedQuery[8]) {
-    //     if(ch == '(') {
-    //         flag = true;
-    //         continue;
-    //     }
-    //     else if(ch == ')') {
-    //         flag = false;
-    //         continue;
-    //     }
-
-    //     if(flag) {
-    //         str.push_back(ch);
-    //     }
-    // }
-
-    // parsedQuery.groupby = tokenizedQuery[];
-
-    string binaryOperator = tokenizedQuery[9];
+    string binaryOperator = tokenizedQuery[fromIndex + 4];
     if (binaryOperator == "<")
         parsedQuery.groupbyBinaryOperator = LESS_THAN;
     else if (binaryOperator == ">")
@@ -91,7 +85,14 @@ bool syntacticParseGROUPBY()
         return false;
     }
 
-    parsedQuery.groupbyConditionValue = stoi(tokenizedQuery[10]);
+    regex numeric("[-]?[0-9]+");
+    string value = tokenizedQuery[fromIndex + 5];
+    if (!regex_match(value, numeric))
+    {
+        cout << "SYNTAX ERROR" << endl;
+        return false;
+    }
+    parsedQuery.groupbyConditionValue = stoll(value);
 
     return true;
 }
@@ -100,7 +101,7 @@ bool semanticParseGROUPBY()
 {
     logger.log("semanticParseGROUPBY");
 
-    if (tableCatalogue.isTable(parsedQuery.joinResultRelationName))
+    if (tableCatalogue.isTable(parsedQuery.groupbyResultRelationName))
     {
         cout << "SEMANTIC ERROR: Resultant relation already exists" << endl;
         return false;
@@ -112,10 +113,27 @@ bool semanticParseGROUPBY()
         return false;
     }
 
-    if (!tableCatalogue.isColumnFromTable(parsedQuery.groupbyColumnName, parsedQuery.groupbyRelationName) || 
-        !tableCatalogue.isColumnFromTable(parsedQuery.groupbyGroupingColumnName, parsedQuery.groupbyRelationName))
+    vector<string> columnNames = parsedQuery.groupbyColumnNames;
+    columnNames.insert(columnNames.end(), parsedQuery.groupbyReturnColumnNames.begin(),
+                       parsedQuery.groupbyReturnColumnNames.end());
+    if (parsedQuery.groupbyBinaryOperator != NO_BINOP_CLAUSE)
+        columnNames.push_back(parsedQuery.groupbyHavingColumnName);
+    for (string columnName : columnNames)
+        if (!tableCatalogue.isColumnFromTable(columnName, parsedQuery.groupbyRelationName))
+        {
+            cout << "SEMANTIC ERROR: Column doesn't exist in relation" << endl;
+            return false;
+        }
+
+    // the grouping attributes and the returned aggregates become the columns
+    // of the resultant relation, so they have to be distinct
+    unordered_set<string> resultColumnNames(parsedQuery.groupbyColumnNames.begin(),
+                                            parsedQuery.groupbyColumnNames.end());
+    for (int i = 0; i < parsedQuery.groupbyReturnFunctions.size(); i++)
+        resultColumnNames.insert(parsedQuery.groupbyReturnFunctions[i] + parsedQuery.groupbyReturnColumnNames[i]);
+    if (resultColumnNames.size() != parsedQuery.groupbyColumnNames.size() + parsedQuery.groupbyReturnFunctions.size())
     {
-        cout << "SEMANTIC ERROR: Column doesn't exist in relation" << endl;
+        cout << "SEMANTIC ERROR: Duplicate column in resultant relation" << endl;
         return false;
     }
     return true;
@@ -126,82 +144,29 @@ void executeGROUPBY()
     logger.log("executeGROUPBY");
 
     Table* table = tableCatalogue.getTable(parsedQuery.groupbyRelationName);
-    
-    // create trimmed table by taking only the two required columns
-    vector<string> trimmedTableCols;
-    trimmedTableCols.push_back(parsedQuery.groupbyColumnName);
-    trimmedTableCols.push_back(parsedQuery.groupbyGroupingColumnName);
-
-    Table* trimmedTable = new Table(parsedQuery.groupbyResultRelationName+"trimmedTable", trimmedTableCols);
-    tableCatalogue.insertTable(trimmedTable);
-
-    // copy only the required columns from original table into trim table
-    trimmedTable->trim(table);
-
-    // get sorting strategy
-    vector<int> sortingStrategy;    
-    sortingStrategy.push_back(ASC);
-
-    // get sorting col name
-    vector<string> sortColumnNames;
-    sortColumnNames.push_back(parsedQuery.groupbyColumnName);
-
-    // // sort 
-    trimmedTable->sortTable(sortColumnNames, sortingStrategy);
-    // table->sortTable(sortColumnNames, sortingStrategy);
-
-    vector<string> trimmedTableCols2;
-    trimmedTableCols2.push_back(parsedQuery.groupbyColumnName);
-    // trimmedTableCols2.push_back(parsedQuery.groupbyGroupingColumnName);
-    trimmedTableCols2.push_back("MAX");
-    trimmedTableCols2.push_back("MIN");
-    trimmedTableCols2.push_back("SUM");
-    trimmedTableCols2.push_back("COUNT");
-
-    Table* groupbyCalculations = new Table(parsedQuery.groupbyResultRelationName+"trimmedTable2", trimmedTableCols2);
-    tableCatalogue.insertTable(groupbyCalculations);
-
-    groupbyCalculations->calculate(trimmedTable);
-    // groupbyCalculations->calculate(table);
-
-    vector<string> resTableCols;
-    resTableCols.push_back(parsedQuery.groupbyColumnName);
-    resTableCols.push_back(parsedQuery.groupbyAggregateFunc2+parsedQuery.groupbyGroupingColumnName);
+
+    vector<string> resTableCols = parsedQuery.groupbyColumnNames;
+    for (int i = 0; i < parsedQuery.groupbyReturnFunctions.size(); i++)
+        resTableCols.push_back(parsedQuery.groupbyReturnFunctions[i] + parsedQuery.groupbyReturnColumnNames[i]);
     Table* resTable = new Table(parsedQuery.groupbyResultRelationName, resTableCols);
     tableCatalogue.insertTable(resTable);
 
-    resTable->groupBy(groupbyCalculations, parsedQuery.groupbyAggregateFunc1, parsedQuery.groupbyAggregateFunc2, 
-                    parsedQuery.groupbyBinaryOperator, parsedQuery.groupbyConditionValue);
+    bool inRange = resTable->groupBy(table, parsedQuery.groupbyColumnNames,
+                                     parsedQuery.groupbyHavingFunction, parsedQuery.groupbyHavingColumnName,
+                                     parsedQuery.groupbyBinaryOperator, parsedQuery.groupbyConditionValue,
+                                     parsedQuery.groupbyReturnFunctions, parsedQuery.groupbyReturnColumnNames);
+    if (!inRange)
+    {
+        cout << "ERROR: Aggregate value does not fit in an integer column" << endl;
+        tableCatalogue.deleteTable(resTable->tableName);
+        return;
+    }
 
     // delete resultant csv file
     string filename = "../data/temp/" + resTable->tableName + ".csv";
     logger.log("csv file to be deleted: " + filename);
     if(remove(filename.c_str()) == 0)   logger.log("csv file deleted successfully");
     else                                logger.log("csv file deleteion unsuccessful");
-    
-    // delete resTrimmedtable csv  
-    filename = "../data/temp/" + parsedQuery.groupbyResultRelationName+"trimmedTable" + ".csv";
-    logger.log("csv file to be deleted: " + filename);
-    if(remove(filename.c_str()) == 0)   logger.log("csv file deleted successfully");
-    else                                logger.log("csv file deleteion unsuccessful");  
-    
-    // delete resTrimmedtable2 csv
-    filename = "../data/temp/" + parsedQuery.groupbyResultRelationName+"trimmedTable2" + ".csv";
-    logger.log("csv file to be deleted: " + filename);
-    if(remove(filename.c_str()) == 0)   logger.log("csv file deleted successfully");
-    else                                logger.log("csv file deleteion unsuccessful");
-    
-    // delete pages of resTrimmedtable
-    int pageIdx = 0;
-    while(bufferManager.removeFromPool(parsedQuery.groupbyResultRelationName+"trimmedTable", pageIdx)){ ++pageIdx;}
-    tableCatalogue.deleteTable(parsedQuery.groupbyResultRelationName+"trimmedTable");
-    bufferManager.deleteFile(parsedQuery.groupbyResultRelationName+"trimmedTable");
-
-    // delete pages of resTrimmedtable2
-    pageIdx = 0;
-    while(bufferManager.removeFromPool(parsedQuery.groupbyResultRelationName+"trimmedTable2", pageIdx)){ ++pageIdx;}
-    tableCatalogue.deleteTable(parsedQuery.groupbyResultRelationName+"trimmedTable2");
-    bufferManager.deleteFile(parsedQuery.groupbyResultRelationName+"trimmedTable2");
 
     return;
 }
@@ -2,12 +2,16 @@
 /**
  * @brief 
  * SYNTAX: INDEX ON column_name FROM relation_name USING indexing_strategy
- * indexing_strategy: ASC | DESC | NOTHING
+ *             [INCLUDE column_name, ...]
+ * indexing_strategy: BTREE | HASH | BITMAP | BLOOM | NOTHING
+ * INCLUDE is only allowed with BTREE.
  */
 bool syntacticParseINDEX()
 {
     logger.log("syntacticParseINDEX");
-    if (tokenizedQuery.size() != 7 || tokenizedQuery[1] != "ON" || tokenizedQuery[3] != "FROM" || tokenizedQuery[5] != "USING")
+    if ((tokenizedQuery.size() != 7 && (tokenizedQuery.size() < 9 || tokenizedQuery[7] != "INCLUDE" ||
+                                        tokenizedQuery[6] != "BTREE")) ||
+        tokenizedQuery[1] != "ON" || tokenizedQuery[3] != "FROM" || tokenizedQuery[5] != "USING")
     {
         cout << "SYNTAX ERROR" << endl;
         return false;
@@ -15,11 +19,17 @@ bool syntacticParseINDEX()
     parsedQuery.queryType = INDEX;
     parsedQuery.indexColumnName = tokenizedQuery[2];
     parsedQuery.indexRelationName = tokenizedQuery[4];
+    for (int tokenCounter = 8; tokenCounter < tokenizedQuery.size(); tokenCounter++)
+        parsedQuery.indexIncludedColumns.push_back(tokenizedQuery[tokenCounter]);
     string indexingStrategy = tokenizedQuery[6];
     if (indexingStrategy == "BTREE")
         parsedQuery.indexingStrategy = BTREE;
     else if (indexingStrategy == "HASH")
         parsedQuery.indexingStrategy = HASH;
+    else if (indexingStrategy == "BITMAP")
+        parsedQuery.indexingStrategy = BITMAP;
+    else if (indexingStrategy == "BLOOM")
+        parsedQuery.indexingStrategy = BLOOM;
     else if (indexingStrategy == "NOTHING")
         parsedQuery.indexingStrategy = NOTHING;
     else
@@ -43,16 +53,63 @@ bool semanticParseINDEX()
         cout << "SEMANTIC ERROR: Column doesn't exist in relation" << endl;
         return false;
     }
+    unordered_set<string> includedColumns;
+    for (string &columnName : parsedQuery.indexIncludedColumns)
+    {
+        if (!tableCatalogue.isColumnFromTable(columnName, parsedQuery.indexRelationName))
+        {
+            cout << "SEMANTIC ERROR: Column doesn't exist in relation" << endl;
+            return false;
+        }
+        if (columnName == parsedQuery.indexColumnName || !includedColumns.insert(columnName).second)
+        {
+            cout << "SEMANTIC ERROR: Duplicate column in index" << endl;
+            return false;
+        }
+    }
     Table* table = tableCatalogue.getTable(parsedQuery.indexRelationName);
-    if(table->indexed){
+    bool bitmapIndexed = table->isBitmapIndexed(parsedQuery.indexColumnName);
+    bool bloomFiltered = table->bloomFilterIndex(parsedQuery.indexColumnName) != -1;
+    if((bitmapIndexed && parsedQuery.indexingStrategy == BITMAP) ||
+       (bloomFiltered && parsedQuery.indexingStrategy == BLOOM)){
+        cout << "SEMANTIC ERROR: Column already indexed" << endl;
+        return false;
+    }
+    if(table->indexed && (parsedQuery.indexingStrategy == BTREE || parsedQuery.indexingStrategy == HASH)){
         cout << "SEMANTIC ERROR: Table already indexed" << endl;
         return false;
     }
+    if(!table->indexed && !bitmapIndexed && !bloomFiltered && parsedQuery.indexingStrategy == NOTHING){
+        cout << "SEMANTIC ERROR: Table not indexed" << endl;
+        return false;
+    }
     return true;
 }
 
+/**
+ * @brief Builds the index, or removes it when the strategy is NOTHING. See
+ * Table::buildIndex and Table::saveIndexCatalogue.
+ */
 void executeINDEX()
 {
     logger.log("executeINDEX");
+    Table* table = tableCatalogue.getTable(parsedQuery.indexRelationName);
+    table->buildIndex(parsedQuery.indexColumnName, parsedQuery.indexingStrategy,
+                      parsedQuery.indexIncludedColumns);
+    // kept for the next LOAD of the table while it matches its source file
+    table->saveIndexCatalogue();
+
+    if (parsedQuery.indexingStrategy == NOTHING)
+        cout << "Index removed." << endl;
+    else
+        cout << "Indexed Table." << endl;
+
+    cout<< "No. of blocks read: " << blockReadCounter << endl; 
+    cout<< "No. of blocks written: " << blockWriteCounter << endl; 
+    cout<< "No. of blocks accessed: " << blockReadCounter + blockWriteCounter << endl; 
+    cout<< "No. of merge passes: " << mergePassCounter << endl; 
+    blockReadCounter = 0;
+    blockWriteCounter = 0;
+    mergePassCounter = 0;
     return;
 }
\ No newline at end of file
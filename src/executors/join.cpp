@@ -69,30 +69,102 @@ void executeJOIN()
     Table* table1 = tableCatalogue.getTable(parsedQuery.joinFirstRelationName);
     Table* table2 = tableCatalogue.getTable(parsedQuery.joinSecondRelationName);
 
-    vector<int> sortingStrategy;
-    if(parsedQuery.joinBinaryOperator == EQUAL || parsedQuery.joinBinaryOperator == NOT_EQUAL ||
-        parsedQuery.joinBinaryOperator == LESS_THAN || parsedQuery.joinBinaryOperator == LEQ)
-        sortingStrategy.push_back(ASC);
-    else
-        sortingStrategy.push_back(DESC);
-
-    vector<string> sortColumnNames1, sortColumnNames2;
-    sortColumnNames1.push_back(parsedQuery.joinFirstColumnName);
-    sortColumnNames2.push_back(parsedQuery.joinSecondColumnName);
+    // Equi-joins are hash joined directly, without copying or sorting either
+    // relation, as long as one round of partitioning is enough to bring the
+    // smaller relation within the buffer. Larger equi-joins are sort-merge
+    // joined, since the external sort handles any input size in few passes.
+    // != can't make use of either, so it is a block nested-loop join over the
+    // original relations.
+    //
+    // An equi-join where one relation is indexed on its join column probes the
+    // index with the rows of the other instead, when the index pages and the
+    // pages of the matching rows, at most one per row of the other relation
+    // and per match, come to fewer than the blocks of the indexed relation.
+    // When both relations qualify, the one whose blocks plus the index pages
+    // and matching pages of the other come to less is read.
+    uint frames = BLOCK_COUNT - 2;
+    string column1 = parsedQuery.joinFirstColumnName;
+    string column2 = parsedQuery.joinSecondColumnName;
+    // blocks read probing the index of innerTable with the rows of
+    // outerTable, -1 if it has no such index or a scan of it reads fewer
+    auto probeCost = [](Table* outerTable, Table* innerTable, string innerColumn) {
+        if (!innerTable->indexed || innerTable->indexedColumn != innerColumn)
+            return -1LL;
+        // rows of the indexed relation per key, assumed 1 without statistics
+        long long rowsPerKey = 1;
+        if (innerTable->distinctValuesPerColumnCount.size() == innerTable->columnCount)
+        {
+            uint distinctValues = innerTable->distinctValuesPerColumnCount[innerTable->getColumnIndex(innerColumn)];
+            rowsPerKey = max(1LL, innerTable->rowCount / max(distinctValues, 1u));
+        }
+        long long indexCost = outerTable->rowCount * (1 + rowsPerKey);
+        if (indexCost >= innerTable->blockCount)
+            return -1LL;
+        return outerTable->blockCount + indexCost;
+    };
+    long long probeSecondCost = probeCost(table1, table2, column2);
+    long long probeFirstCost = probeCost(table2, table1, column1);
+    bool probeSecond = probeSecondCost != -1 && (probeFirstCost == -1 || probeSecondCost <= probeFirstCost);
+    bool indexJoin = parsedQuery.joinBinaryOperator == EQUAL && (probeSecondCost != -1 || probeFirstCost != -1);
+    // tables already in ascending order of their join column are merged as
+    // they are, which reads each of them once
+    vector<int> sortingStrategy = {ASC};
+    vector<string> sortColumnNames1 = {parsedQuery.joinFirstColumnName};
+    vector<string> sortColumnNames2 = {parsedQuery.joinSecondColumnName};
+    bool sorted1 = table1->isSortedOn(sortColumnNames1, sortingStrategy);
+    bool sorted2 = table2->isSortedOn(sortColumnNames2, sortingStrategy);
+    bool hashJoin = parsedQuery.joinBinaryOperator == EQUAL && !(sorted1 && sorted2) &&
+        min(table1->blockCount, table2->blockCount) <= frames * frames;
+    if (indexJoin || hashJoin || parsedQuery.joinBinaryOperator == NOT_EQUAL)
+    {
+        vector<string> resCols = table1->columns;
+        resCols.insert(resCols.end(), table2->columns.begin(), table2->columns.end());
+        Table* resTable = new Table(parsedQuery.joinResultRelationName, resCols);
+        tableCatalogue.insertTable(resTable);
+
+        if (indexJoin)
+            resTable->indexNestedLoopJoin(table1, table2, column1, column2, probeSecond);
+        else if (hashJoin)
+            resTable->hashJoin(table1, table2, parsedQuery.joinFirstColumnName, parsedQuery.joinSecondColumnName);
+        else
+            resTable->blockNestedLoopJoin(table1, table2, table1->getColumnIndex(parsedQuery.joinFirstColumnName),
+                                          table2->getColumnIndex(parsedQuery.joinSecondColumnName), NOT_EQUAL);
+
+        string filename = "../data/temp/" + resTable->tableName + ".csv";
+        logger.log("csv file to be deleted: " + filename);
+        if(remove(filename.c_str()) == 0)
+            logger.log("csv file deleted successfully");
+        else
+            logger.log("csv file deleteion unsuccessful");
+
+        cout<< "No. of blocks read: " << blockReadCounter << endl; 
+        cout<< "No. of blocks written: " << blockWriteCounter << endl; 
+        cout<< "No. of blocks accessed: " << blockReadCounter + blockWriteCounter << endl; 
+        blockReadCounter = 0;
+        blockWriteCounter = 0;
+        return;
+    }
 
-    // Make copies of both tables
+    // Make sorted copies of the tables that are not sorted on the join column
     vector<string> cols1 = table1->columns;
-    Table* table1copy = new Table("table1copy", cols1);
-    tableCatalogue.insertTable(table1copy);
-    table1copy->copy(table1);
+    Table* table1copy = table1;
+    if (!sorted1)
+    {
+        table1copy = new Table("table1copy", cols1);
+        tableCatalogue.insertTable(table1copy);
+        table1copy->copy(table1);
+        table1copy->sortTable(sortColumnNames1, sortingStrategy);
+    }
 
     vector<string> cols2 = table2->columns;
-    Table* table2copy = new Table("table2copy", cols2);
-    tableCatalogue.insertTable(table2copy);
-    table2copy->copy(table2);
-
-    table1copy->sortTable(sortColumnNames1, sortingStrategy);
-    table2copy->sortTable(sortColumnNames2, sortingStrategy);
+    Table* table2copy = table2;
+    if (!sorted2)
+    {
+        table2copy = new Table("table2copy", cols2);
+        tableCatalogue.insertTable(table2copy);
+        table2copy->copy(table2);
+        table2copy->sortTable(sortColumnNames2, sortingStrategy);
+    }
 
     // create resultant table
     vector<string> resCols;
@@ -108,7 +180,14 @@ void executeJOIN()
     Table* resTable = new Table(parsedQuery.joinResultRelationName, resCols);
     tableCatalogue.insertTable(resTable);
     
-    resTable->join(table1copy, table2copy, parsedQuery.joinFirstColumnName, parsedQuery.joinSecondColumnName, parsedQuery.joinBinaryOperator);
+    if (parsedQuery.joinBinaryOperator == EQUAL)
+    {
+        resTable->mergeJoin(table1copy, table2copy, parsedQuery.joinFirstColumnName, parsedQuery.joinSecondColumnName);
+        resTable->sortedColumns = sortColumnNames1;
+        resTable->sortedStrategy = sortingStrategy;
+    }
+    else
+        resTable->bandJoin(table1copy, table2copy, parsedQuery.joinFirstColumnName, parsedQuery.joinSecondColumnName, parsedQuery.joinBinaryOperator);
 
     // delete resultant csv file
     string filename = "../data/temp/" + resTable->tableName + ".csv";
@@ -118,16 +197,29 @@ void executeJOIN()
     else
         logger.log("csv file deleteion unsuccessful");
 
-    // delete pages of copies of both the original tables
+    // delete pages of the copies made of the original tables
     int pageIdx = 0;
-    while(bufferManager.removeFromPool("table1copy", pageIdx)){ ++pageIdx;}
-    tableCatalogue.deleteTable("table1copy");
-    bufferManager.deleteFile("table1copy");
+    if (!sorted1)
+    {
+        while(bufferManager.removeFromPool("table1copy", pageIdx)){ ++pageIdx;}
+        tableCatalogue.deleteTable("table1copy");
+        bufferManager.deleteFile("table1copy");
+    }
 
     pageIdx = 0;
-    while(bufferManager.removeFromPool("table2copy", pageIdx)){ ++pageIdx;}
-    tableCatalogue.deleteTable("table2copy");
-    bufferManager.deleteFile("table2copy");
+    if (!sorted2)
+    {
+        while(bufferManager.removeFromPool("table2copy", pageIdx)){ ++pageIdx;}
+        tableCatalogue.deleteTable("table2copy");
+        bufferManager.deleteFile("table2copy");
+    }
 
+    cout<< "No. of blocks read: " << blockReadCounter << endl; 
+    cout<< "No. of blocks written: " << blockWriteCounter << endl; 
+    cout<< "No. of blocks accessed: " << blockReadCounter + blockWriteCounter << endl; 
+    cout<< "No. of merge passes: " << mergePassCounter << endl; 
+    blockReadCounter = 0;
+    blockWriteCounter = 0;
+    mergePassCounter = 0;
     return;
 }
\ No newline at end of file
@@ -1,13 +1,13 @@
 #include "global.h"
 /**
  * @brief 
- * SYNTAX: new_table <- ORDER BY attribute ASC|DESC ON table_name
+ * SYNTAX: new_table <- ORDER BY attribute ASC|DESC ON table_name [LIMIT n]
  */
 bool syntacticParseORDERBY()
 {
     logger.log("syntacticParseORDERBY");
     
-    if (tokenizedQuery.size() != 8 || tokenizedQuery[2] != "ORDER" || tokenizedQuery[3] != "BY"
+    if ((tokenizedQuery.size() != 8 && tokenizedQuery.size() != 10) || tokenizedQuery[2] != "ORDER" || tokenizedQuery[3] != "BY"
             || (tokenizedQuery[5] != "ASC" && tokenizedQuery[5] != "DESC") || tokenizedQuery[6] != "ON")
     {
         cout << "SYNTAX ERROR" << endl;
@@ -16,8 +16,20 @@ bool syntacticParseORDERBY()
     parsedQuery.queryType = ORDERBY;
     parsedQuery.orderbyResultRelationName = tokenizedQuery[0];
     parsedQuery.orderbyColumnName = tokenizedQuery[4];
+    parsedQuery.orderbySortingStrategy = tokenizedQuery[5] == "ASC" ? ASC : DESC;
     parsedQuery.orderbyRelationName = tokenizedQuery[7];
 
+    if (tokenizedQuery.size() == 10)
+    {
+        regex positive("[0-9]*[1-9][0-9]*");
+        if (tokenizedQuery[8] != "LIMIT" || !regex_match(tokenizedQuery[9], positive) || tokenizedQuery[9].size() > 18)
+        {
+            cout << "SYNTAX ERROR" << endl;
+            return false;
+        }
+        parsedQuery.orderbyLimit = stoll(tokenizedQuery[9]);
+    }
+
     return true;
 }
 
@@ -56,22 +68,31 @@ void executeORDERBY()
     Table* resTable = new Table(parsedQuery.orderbyResultRelationName, resCols);
     tableCatalogue.insertTable(resTable);
 
-    // copy data original table into resultant table
-    resTable->copy(table);
-
-    // get soting strategy
-    vector<int> sortingStrategy;
-    if(tokenizedQuery[5] == "ASC")
-        sortingStrategy.push_back(ASC);
+    // With a LIMIT whose rows fit in the buffer (leaving one block for the
+    // input page and one for the output) the rows are picked with a bounded
+    // heap in one scan, otherwise the whole table is sorted and cut.
+    long long limit = parsedQuery.orderbyLimit;
+    vector<string> sortColumnNames = {parsedQuery.orderbyColumnName};
+    vector<int> sortingStrategy = {parsedQuery.orderbySortingStrategy};
+    if (table->isSortedOn(sortColumnNames, sortingStrategy))
+    {
+        // already in this order, only the first limit rows are read
+        resTable->copy(table, limit);
+    }
+    else if (limit != -1 && (min(limit, table->rowCount) + resTable->maxRowsPerBlock - 1) / resTable->maxRowsPerBlock <= BLOCK_COUNT - 2)
+    {
+        resTable->topRows(table, parsedQuery.orderbyColumnName, parsedQuery.orderbySortingStrategy, limit);
+    }
     else
-        sortingStrategy.push_back(DESC);
-
-    // get sorting col name
-    vector<string> sortColumnNames;
-    sortColumnNames.push_back(parsedQuery.orderbyColumnName);
+    {
+        // copy data original table into resultant table
+        resTable->copy(table);
 
-    // sort
-    resTable->sortTable(sortColumnNames, sortingStrategy);
+        // sort
+        resTable->sortTable(sortColumnNames, sortingStrategy);
+        if (limit != -1)
+            resTable->truncate(limit);
+    }
 
     // delete resultant csv file
     string filename = "../data/temp/" + resTable->tableName + ".csv";
@@ -81,5 +102,12 @@ void executeORDERBY()
     else
         logger.log("csv file deleteion unsuccessful");
 
+    cout<< "No. of blocks read: " << blockReadCounter << endl; 
+    cout<< "No. of blocks written: " << blockWriteCounter << endl; 
+    cout<< "No. of blocks accessed: " << blockReadCounter + blockWriteCounter << endl; 
+    cout<< "No. of merge passes: " << mergePassCounter << endl; 
+    blockReadCounter = 0;
+    blockWriteCounter = 0;
+    mergePassCounter = 0;
     return;
 }
@@ -52,6 +52,28 @@ void executePROJECTION()
     logger.log("executePROJECTION");
     Table* resultantTable = new Table(parsedQuery.projectionResultRelationName, parsedQuery.projectionColumnList);
     Table table = *tableCatalogue.getTable(parsedQuery.projectionRelationName);
+
+    // Leaves of {key, page, slot, included values...} narrower than the rows
+    // of the table take fewer blocks, and hold every column asked for.
+    if (table.indexCovers(parsedQuery.projectionColumnList) && 3 + table.includedColumns.size() < table.columnCount)
+    {
+        resultantTable->indexOnlyScan(&table, parsedQuery.projectionColumnList, INT_MIN, INT_MAX);
+        cout << "Projected using the BTREE index only." << endl;
+        cout << "No. of blocks read: " << blockReadCounter << endl;
+        cout << "No. of blocks read by a full scan: " << table.blockCount << endl;
+        blockReadCounter = 0;
+        blockWriteCounter = 0;
+        resultantTable->blockify();
+        // rows come out in key order
+        if (resultantTable->isColumn(table.indexedColumn))
+        {
+            resultantTable->sortedColumns = {table.indexedColumn};
+            resultantTable->sortedStrategy = {ASC};
+        }
+        tableCatalogue.insertTable(resultantTable);
+        return;
+    }
+
     Cursor cursor = table.getCursor();
     vector<int> columnIndices;
     for (int columnCounter = 0; columnCounter < parsedQuery.projectionColumnList.size(); columnCounter++)
@@ -72,6 +94,7 @@ void executePROJECTION()
         row = cursor.getNext();
     }
     resultantTable->blockify();
+    resultantTable->inheritSortOrder(&table);
     tableCatalogue.insertTable(resultantTable);
     return;
 }
\ No newline at end of file
@@ -2,11 +2,13 @@
 /**
  * @brief 
  * SYNTAX: R <- SELECT column_name bin_op [column_name | int_literal] FROM relation_name
+ *         R <- SELECT column_name == int_literal [AND | OR] column_name == int_literal ... FROM relation_name
  */
 bool syntacticParseSELECTION()
 {
     logger.log("syntacticParseSELECTION");
-    if (tokenizedQuery.size() != 8 || tokenizedQuery[6] != "FROM")
+    int tokenCount = tokenizedQuery.size();
+    if (tokenCount < 8 || (tokenCount - 8) % 4 != 0 || tokenizedQuery[tokenCount - 2] != "FROM")
     {
         cout << "SYNTAC ERROR" << endl;
         return false;
@@ -14,7 +16,7 @@ bool syntacticParseSELECTION()
     parsedQuery.queryType = SELECTION;
     parsedQuery.selectionResultRelationName = tokenizedQuery[0];
     parsedQuery.selectionFirstColumnName = tokenizedQuery[3];
-    parsedQuery.selectionRelationName = tokenizedQuery[7];
+    parsedQuery.selectionRelationName = tokenizedQuery[tokenCount - 1];
 
     string binaryOperator = tokenizedQuery[4];
     if (binaryOperator == "<")
@@ -46,6 +48,30 @@ bool syntacticParseSELECTION()
         parsedQuery.selectType = COLUMN;
         parsedQuery.selectionSecondColumnName = secondArgument;
     }
+    if (tokenCount == 8)
+        return true;
+
+    // conditions joined by AND and OR must all be column_name == int_literal
+    if (parsedQuery.selectionBinaryOperator != EQUAL || parsedQuery.selectType != INT_LITERAL)
+    {
+        cout << "SYNTAX ERROR" << endl;
+        return false;
+    }
+    parsedQuery.selectionEqualities = {{{parsedQuery.selectionFirstColumnName, parsedQuery.selectionIntLiteral}}};
+    for (int tokenCounter = 6; tokenCounter < tokenCount - 2; tokenCounter += 4)
+    {
+        string connective = tokenizedQuery[tokenCounter];
+        if ((connective != "AND" && connective != "OR") || tokenizedQuery[tokenCounter + 2] != "==" ||
+            !regex_match(tokenizedQuery[tokenCounter + 3], numeric))
+        {
+            cout << "SYNTAX ERROR" << endl;
+            return false;
+        }
+        if (connective == "OR")
+            parsedQuery.selectionEqualities.emplace_back();
+        parsedQuery.selectionEqualities.back().emplace_back(tokenizedQuery[tokenCounter + 1],
+                                                            stoi(tokenizedQuery[tokenCounter + 3]));
+    }
     return true;
 }
 
@@ -79,10 +105,18 @@ bool semanticParseSELECTION()
             return false;
         }
     }
+
+    for (vector<pair<string, int>> &conjunction : parsedQuery.selectionEqualities)
+        for (pair<string, int> &equality : conjunction)
+            if (!tableCatalogue.isColumnFromTable(equality.first, parsedQuery.selectionRelationName))
+            {
+                cout << "SEMANTIC ERROR: Column doesn't exist in relation" << endl;
+                return false;
+            }
     return true;
 }
 
-bool evaluateBinOp(int value1, int value2, BinaryOperator binaryOperator)
+bool evaluateBinOp(long long value1, long long value2, BinaryOperator binaryOperator)
 {
     logger.log("Evaluate Binary Op");
     logger.log("Val1 = " + to_string(value1) + " Val2 = " + to_string(value2) +
@@ -106,20 +140,397 @@ bool evaluateBinOp(int value1, int value2, BinaryOperator binaryOperator)
     }
 }
 
+/**
+ * @brief Gives the range [lowKey, highKey] of values of the column that
+ * satisfy column binop int_literal, for any operator but !=.
+ *
+ * @param lowKey
+ * @param highKey
+ */
+void literalRange(long long &lowKey, long long &highKey)
+{
+    BinaryOperator binaryOperator = parsedQuery.selectionBinaryOperator;
+    long long key = parsedQuery.selectionIntLiteral;
+    lowKey = INT_MIN, highKey = INT_MAX;
+    if (binaryOperator == EQUAL || binaryOperator == GEQ)
+        lowKey = key;
+    else if (binaryOperator == GREATER_THAN)
+        lowKey = key + 1;
+    if (binaryOperator == EQUAL || binaryOperator == LEQ)
+        highKey = key;
+    else if (binaryOperator == LESS_THAN)
+        highKey = key - 1;
+}
+
+/**
+ * @brief Selects the rows through the index of table when the index is on
+ * the first column and the condition compares it with a literal: a B+ tree
+ * serves ==, <, <=, > and >=, a hash index only ==. The locations found in
+ * the index are sorted so that every page holding a selected row is read
+ * once, in page order, and the rows are written in table order as a scan
+ * would write them. The index is not used when the index pages read and the
+ * pages holding selected rows come to as many blocks as a scan reads.
+ *
+ * @param table
+ * @param resultantTable
+ * @return true if the index was used
+ */
+bool indexedSelection(Table *table, Table *resultantTable)
+{
+    logger.log("indexedSelection");
+    BinaryOperator binaryOperator = parsedQuery.selectionBinaryOperator;
+    if (!parsedQuery.selectionEqualities.empty() || parsedQuery.selectType != INT_LITERAL || !table->indexed ||
+        table->indexedColumn != parsedQuery.selectionFirstColumnName ||
+        binaryOperator == NOT_EQUAL || (table->indexingStrategy == HASH && binaryOperator != EQUAL))
+        return false;
+
+    long long lowKey, highKey;
+    literalRange(lowKey, highKey);
+
+    uint indexBlockCount = blockReadCounter;
+    // the leaves of a B+ tree range are counted before any is read
+    if (table->indexingStrategy == BTREE &&
+        blockReadCounter - indexBlockCount + table->indexLeafCount(lowKey, highKey) >= table->blockCount)
+        return false;
+    vector<pair<int, int>> locations = table->indexLookup(lowKey, highKey);
+    indexBlockCount = blockReadCounter - indexBlockCount;
+    sort(locations.begin(), locations.end());
+    uint pageCount = 0;
+    for (int locationCounter = 0; locationCounter < locations.size(); locationCounter++)
+        if (locationCounter == 0 || locations[locationCounter].first != locations[locationCounter - 1].first)
+            pageCount++;
+    // a scan reads no more blocks than the index and the pages it points to
+    if (indexBlockCount + pageCount >= table->blockCount)
+        return false;
+    int pageIndex = -1;
+    vector<vector<int>> rows;
+    for (pair<int, int> &location : locations)
+    {
+        if (location.first != pageIndex)
+        {
+            pageIndex = location.first;
+            rows = table->readPage(pageIndex);
+        }
+        resultantTable->writeRow<int>(rows[location.second]);
+    }
+    return true;
+}
+
+/**
+ * @brief Selects the rows of a table sorted on the column compared with a
+ * literal, where the selected rows are next to each other. The first page
+ * that may hold one is found by binary search on the last row of the pages,
+ * and the pages from there are read until a row lies past the selected
+ * range. != selects rows at both ends and is left to the scan.
+ *
+ * @param table
+ * @param resultantTable
+ * @return true if the sort order was used
+ */
+bool sortedSelection(Table *table, Table *resultantTable)
+{
+    logger.log("sortedSelection");
+    BinaryOperator binaryOperator = parsedQuery.selectionBinaryOperator;
+    if (!parsedQuery.selectionEqualities.empty() || parsedQuery.selectType != INT_LITERAL ||
+        binaryOperator == NOT_EQUAL || table->sortedColumns.empty() ||
+        table->sortedColumns[0] != parsedQuery.selectionFirstColumnName)
+        return false;
+
+    long long lowKey, highKey;
+    literalRange(lowKey, highKey);
+    int columnIndex = table->getColumnIndex(parsedQuery.selectionFirstColumnName);
+    bool ascending = table->sortedStrategy[0] == ASC;
+    auto before = [&](int value) { return ascending ? value < lowKey : value > highKey; };
+    auto after = [&](int value) { return ascending ? value > highKey : value < lowKey; };
+
+    // first page whose last row is not before the range, page 0 when the
+    // range is open at that end
+    int lowPage = 0, highPage = (ascending ? lowKey == INT_MIN : highKey == INT_MAX) ? 0 : table->blockCount;
+    while (lowPage < highPage)
+    {
+        int middlePage = (lowPage + highPage) / 2;
+        if (before(table->readPage(middlePage).back()[columnIndex]))
+            lowPage = middlePage + 1;
+        else
+            highPage = middlePage;
+    }
+    for (int pageCounter = lowPage; pageCounter < table->blockCount; pageCounter++)
+    {
+        vector<vector<int>> rows = table->readPage(pageCounter);
+        for (vector<int> &row : rows)
+        {
+            if (after(row[columnIndex]))
+                return true;
+            if (!before(row[columnIndex]))
+                resultantTable->writeRow<int>(row);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Selects the rows from the leaves of a BTREE index on the column
+ * compared with a literal when the index includes every other column of the
+ * table, reading no page of the table. Only the leaves holding selected rows
+ * are read, and the rows come out in key order. A leaf entry is wider than a
+ * row, so the leaves are not used when the internal nodes read to count the
+ * leaves of the range and those leaves come to as many blocks as a scan
+ * reads.
+ *
+ * @param table
+ * @param resultantTable
+ * @return true if the index alone was used
+ */
+bool coveringSelection(Table *table, Table *resultantTable)
+{
+    logger.log("coveringSelection");
+    if (!parsedQuery.selectionEqualities.empty() || parsedQuery.selectType != INT_LITERAL ||
+        parsedQuery.selectionBinaryOperator == NOT_EQUAL || !table->indexCovers(table->columns) ||
+        table->indexedColumn != parsedQuery.selectionFirstColumnName)
+        return false;
+    long long lowKey, highKey;
+    literalRange(lowKey, highKey);
+    uint indexBlockCount = blockReadCounter;
+    long long leafCount = table->indexLeafCount(lowKey, highKey);
+    indexBlockCount = blockReadCounter - indexBlockCount;
+    if (indexBlockCount + leafCount >= table->blockCount)
+        return false;
+    resultantTable->indexOnlyScan(table, table->columns, lowKey, highKey);
+    return true;
+}
+
+/**
+ * @brief Returns the conditions of the query as equalities {column index,
+ * int_literal} of table, an OR of ANDs, taking a single condition
+ * column_name == int_literal as one equality. Empty if the condition is of
+ * another form.
+ *
+ * @param table
+ * @return vector<vector<pair<int, int>>>
+ */
+vector<vector<pair<int, int>>> selectionEqualities(Table *table)
+{
+    vector<vector<pair<string, int>>> equalities = parsedQuery.selectionEqualities;
+    if (equalities.empty() && parsedQuery.selectType == INT_LITERAL && parsedQuery.selectionBinaryOperator == EQUAL)
+        equalities = {{{parsedQuery.selectionFirstColumnName, parsedQuery.selectionIntLiteral}}};
+    vector<vector<pair<int, int>>> equalityIndices;
+    for (vector<pair<string, int>> &conjunction : equalities)
+    {
+        equalityIndices.emplace_back();
+        for (pair<string, int> &equality : conjunction)
+            equalityIndices.back().emplace_back(table->getColumnIndex(equality.first), equality.second);
+    }
+    return equalityIndices;
+}
+
+bool evaluateEqualities(vector<int> &row, vector<vector<pair<int, int>>> &equalities)
+{
+    for (vector<pair<int, int>> &conjunction : equalities)
+    {
+        bool selected = true;
+        for (pair<int, int> &equality : conjunction)
+            selected = selected && row[equality.first] == equality.second;
+        if (selected)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Selects the rows by reading only the pages that may hold some when
+ * the condition is made of equalities column_name == int_literal and the
+ * pages have Bloom filters on some of their columns: a page is skipped when,
+ * for every group of equalities joined by AND, the filter of the page on one
+ * of its columns rules out the literal. A group with no filtered column rules
+ * out no page, so the filters are used only when every group has one.
+ *
+ * @param table
+ * @param resultantTable
+ * @return true if the Bloom filters were used
+ */
+bool bloomSelection(Table *table, Table *resultantTable)
+{
+    logger.log("bloomSelection");
+    vector<vector<pair<int, int>>> equalities = selectionEqualities(table);
+    // {filter, int_literal} of the equalities on columns with Bloom filters
+    vector<vector<pair<int, int>>> filterChecks;
+    bool filtered = !equalities.empty();
+    for (vector<pair<int, int>> &conjunction : equalities)
+    {
+        filterChecks.emplace_back();
+        for (pair<int, int> &equality : conjunction)
+        {
+            int filterIndex = table->bloomFilterIndex(table->columns[equality.first]);
+            if (filterIndex != -1)
+                filterChecks.back().emplace_back(filterIndex, equality.second);
+        }
+        filtered = filtered && !filterChecks.back().empty();
+    }
+    if (!filtered)
+        return false;
+
+    for (int pageCounter = 0; pageCounter < table->blockCount; pageCounter++)
+    {
+        bool mayMatch = false;
+        for (int conjunctionCounter = 0; conjunctionCounter < filterChecks.size() && !mayMatch; conjunctionCounter++)
+        {
+            mayMatch = true;
+            for (pair<int, int> &check : filterChecks[conjunctionCounter])
+                mayMatch = mayMatch && table->bloomFilters[check.first][pageCounter].mayContain(check.second);
+        }
+        if (!mayMatch)
+            continue;
+        vector<vector<int>> rows = table->readPage(pageCounter);
+        for (vector<int> &row : rows)
+            if (evaluateEqualities(row, equalities))
+                resultantTable->writeRow<int>(row);
+    }
+    return true;
+}
+
+/**
+ * @brief Selects the rows through bitmap indexes when the condition is made of
+ * equalities column_name == int_literal on columns that all have one. The
+ * bitmaps of the equalities joined by AND are intersected, and those of the
+ * groups joined by OR united, reading no page of the table; only the pages
+ * holding the selected rows are then read, in order. The bitmaps are not used
+ * when the bitmap pages read and the pages holding selected rows come to as
+ * many blocks as a scan reads.
+ *
+ * @param table
+ * @param resultantTable
+ * @return true if the bitmap indexes were used
+ */
+bool bitmapSelection(Table *table, Table *resultantTable)
+{
+    logger.log("bitmapSelection");
+    vector<vector<pair<string, int>>> equalities = parsedQuery.selectionEqualities;
+    if (equalities.empty())
+    {
+        if (parsedQuery.selectType != INT_LITERAL || parsedQuery.selectionBinaryOperator != EQUAL)
+            return false;
+        equalities = {{{parsedQuery.selectionFirstColumnName, parsedQuery.selectionIntLiteral}}};
+    }
+    for (vector<pair<string, int>> &conjunction : equalities)
+        for (pair<string, int> &equality : conjunction)
+            if (!table->isBitmapIndexed(equality.first))
+                return false;
+
+    uint indexBlockCount = blockReadCounter;
+    RoaringBitmap selectedRows;
+    for (vector<pair<string, int>> &conjunction : equalities)
+    {
+        RoaringBitmap matchingRows = table->bitmapLookup(conjunction[0].first, conjunction[0].second);
+        for (int equalityCounter = 1; equalityCounter < conjunction.size() && matchingRows.cardinality();
+             equalityCounter++)
+        {
+            RoaringBitmap rows = table->bitmapLookup(conjunction[equalityCounter].first,
+                                                     conjunction[equalityCounter].second);
+            matchingRows = RoaringBitmap::intersect(matchingRows, rows);
+        }
+        selectedRows = RoaringBitmap::unite(selectedRows, matchingRows);
+    }
+    indexBlockCount = blockReadCounter - indexBlockCount;
+
+    // rows are numbered in table order, page after page
+    vector<uint> rowNumbers = selectedRows.values();
+    uint pageIndex = 0, firstRowOfPage = 0, pageCount = 0;
+    for (uint rowNumber : rowNumbers)
+    {
+        bool newPage = pageCount == 0;
+        while (rowNumber >= firstRowOfPage + table->rowsPerBlockCount[pageIndex])
+        {
+            firstRowOfPage += table->rowsPerBlockCount[pageIndex++];
+            newPage = true;
+        }
+        pageCount += newPage;
+    }
+    // a scan reads no more blocks than the bitmaps and the pages they point to
+    if (indexBlockCount + pageCount >= table->blockCount)
+        return false;
+
+    pageIndex = 0, firstRowOfPage = 0;
+    int readPageIndex = -1;
+    vector<vector<int>> rows;
+    for (uint rowNumber : rowNumbers)
+    {
+        while (rowNumber >= firstRowOfPage + table->rowsPerBlockCount[pageIndex])
+            firstRowOfPage += table->rowsPerBlockCount[pageIndex++];
+        if (readPageIndex != pageIndex)
+        {
+            readPageIndex = pageIndex;
+            rows = table->readPage(pageIndex);
+        }
+        resultantTable->writeRow<int>(rows[rowNumber - firstRowOfPage]);
+    }
+    return true;
+}
+
 void executeSELECTION()
 {
     logger.log("executeSELECTION");
 
     Table table = *tableCatalogue.getTable(parsedQuery.selectionRelationName);
     Table* resultantTable = new Table(parsedQuery.selectionResultRelationName, table.columns);
+    // blockify gives the pages of the result Bloom filters on the same columns
+    resultantTable->bloomColumns = table.bloomColumns;
+    string accessPath = "";
+    if (sortedSelection(&table, resultantTable))
+        accessPath = "the sort order";
+    else if (coveringSelection(&table, resultantTable))
+        accessPath = "the BTREE index only";
+    else if (bitmapSelection(&table, resultantTable))
+        accessPath = "the BITMAP index";
+    else if (indexedSelection(&table, resultantTable))
+        accessPath = table.indexingStrategy == HASH ? "the HASH index" : "the BTREE index";
+    else if (bloomSelection(&table, resultantTable))
+        accessPath = "the BLOOM index";
+    if (!accessPath.empty())
+    {
+        cout << "Selected using " << accessPath << "." << endl;
+        cout << "No. of blocks read: " << blockReadCounter << endl;
+        cout << "No. of blocks read by a full scan: " << table.blockCount << endl;
+        blockReadCounter = 0;
+        blockWriteCounter = 0;
+        if(resultantTable->blockify())
+        {
+            // every other access path writes the rows in table order
+            if (accessPath == "the BTREE index only")
+            {
+                resultantTable->sortedColumns = {table.indexedColumn};
+                resultantTable->sortedStrategy = {ASC};
+            }
+            else
+                resultantTable->inheritSortOrder(&table);
+            tableCatalogue.insertTable(resultantTable);
+        }
+        else{
+            cout<<"Empty Table"<<endl;
+            resultantTable->unload();
+            delete resultantTable;
+        }
+        return;
+    }
+    // blocks of an index that was read and then judged worse than a scan
+    uint indexBlockCount = blockReadCounter;
     Cursor cursor = table.getCursor();
     vector<int> row = cursor.getNext();
     int firstColumnIndex = table.getColumnIndex(parsedQuery.selectionFirstColumnName);
     int secondColumnIndex;
     if (parsedQuery.selectType == COLUMN)
         secondColumnIndex = table.getColumnIndex(parsedQuery.selectionSecondColumnName);
+    vector<vector<pair<int, int>>> equalities;
+    if (!parsedQuery.selectionEqualities.empty())
+        equalities = selectionEqualities(&table);
     while (!row.empty())
     {
+        if (!equalities.empty())
+        {
+            if (evaluateEqualities(row, equalities))
+                resultantTable->writeRow<int>(row);
+            row = cursor.getNext();
+            continue;
+        }
 
         int value1 = row[firstColumnIndex];
         int value2;
@@ -131,8 +542,19 @@ void executeSELECTION()
             resultantTable->writeRow<int>(row);
         row = cursor.getNext();
     }
+    if (indexBlockCount)
+    {
+        cout << "Selected using a full scan." << endl;
+        cout << "No. of blocks read: " << blockReadCounter << endl;
+        cout << "No. of blocks read by a full scan: " << table.blockCount << endl;
+        blockReadCounter = 0;
+        blockWriteCounter = 0;
+    }
     if(resultantTable->blockify())
+    {
+        resultantTable->inheritSortOrder(&table);
         tableCatalogue.insertTable(resultantTable);
+    }
     else{
         cout<<"Empty Table"<<endl;
         resultantTable->unload();
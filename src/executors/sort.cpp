@@ -79,5 +79,13 @@ void executeSORT(){
 
     cout<<"Sorted Table."<<endl;
 
+    cout<< "No. of blocks read: " << blockReadCounter << endl; 
+    cout<< "No. of blocks written: " << blockWriteCounter << endl; 
+    cout<< "No. of blocks accessed: " << blockReadCounter + blockWriteCounter << endl; 
+    cout<< "No. of merge passes: " << mergePassCounter << endl; 
+    blockReadCounter = 0;
+    blockWriteCounter = 0;
+    mergePassCounter = 0;
+
     return;
 }
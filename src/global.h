@@ -11,3 +11,4 @@ extern BufferManager bufferManager;
 extern MatrixCatalogue matrixCatalogue;
 extern uint blockReadCounter;
 extern uint blockWriteCounter;
+extern uint mergePassCounter;
@@ -0,0 +1,227 @@
+#include "global.h"
+
+/**
+ * @brief Construct a handle on the hash index stored under indexName. Nothing
+ * is read until the index is used.
+ *
+ * @param indexName
+ */
+HashIndex::HashIndex(string indexName)
+{
+    logger.log("HashIndex::HashIndex");
+    this->indexName = indexName;
+}
+
+/**
+ * @brief Number of {key, page, slot} entries that fit in a bucket page
+ * besides its header.
+ *
+ * @return uint
+ */
+uint HashIndex::bucketCapacity()
+{
+    return (uint)((BLOCK_SIZE * 1000) / (sizeof(int) * 3)) - 1;
+}
+
+uint HashIndex::bucketCount()
+{
+    return (1u << this->level) + this->nextBucket;
+}
+
+void HashIndex::readMeta()
+{
+    logger.log("HashIndex::readMeta");
+    vector<vector<int>> meta = bufferManager.getIndexPage(this->indexName, 0).rows;
+    this->level = meta[0][0];
+    this->nextBucket = meta[0][1];
+    this->overflowCount = meta[0][2];
+    this->entryCount = meta[0][3];
+}
+
+void HashIndex::writeMeta()
+{
+    logger.log("HashIndex::writeMeta");
+    vector<vector<int>> meta = {{(int)this->level, (int)this->nextBucket,
+                                 (int)this->overflowCount, (int)this->entryCount}};
+    bufferManager.writeIndexPage(this->indexName, 0, meta);
+}
+
+/**
+ * @brief Sets up an empty index with as many buckets as entryCount entries
+ * need to stay below LOAD_FACTOR of their room.
+ *
+ * @param entryCount
+ */
+void HashIndex::presize(long long entryCount)
+{
+    logger.log("HashIndex::presize");
+    uint buckets = max(1LL, (long long)ceil(entryCount / (LOAD_FACTOR * this->bucketCapacity())));
+    this->level = 0;
+    while ((2u << this->level) <= buckets)
+        this->level++;
+    this->nextBucket = buckets - (1u << this->level);
+    this->overflowCount = 0;
+    this->entryCount = 0;
+}
+
+/**
+ * @brief Returns the bucket that holds key.
+ *
+ * @param key
+ * @return uint
+ */
+uint HashIndex::bucketOf(int key)
+{
+    uint bucket = HashTable::partitionOf(key, 0, 1u << this->level);
+    if (bucket < this->nextBucket)
+        bucket = HashTable::partitionOf(key, 0, 1u << (this->level + 1));
+    return bucket;
+}
+
+/**
+ * @brief Fills the index set up by presize from entries, a table of rows
+ * {bucket, key, page, slot} sorted on bucket. The buckets are written one
+ * after the other as the entries are read, a bucket that has more entries
+ * than fit in a page being continued on overflow pages.
+ *
+ * @param entries
+ */
+void HashIndex::bulkLoad(Table *entries)
+{
+    logger.log("HashIndex::bulkLoad");
+    uint bucket = 0;
+    int pageIndex = bucket + 1;
+    string pageIndexName = this->indexName;
+    vector<vector<int>> rows = {{-1}};
+    // writes the page being filled, moving on to an overflow page of the same
+    // bucket if moreEntries, or else to the first page of the next bucket
+    auto writePage = [&](bool moreEntries) {
+        if (moreEntries)
+            rows[0][0] = this->overflowCount;
+        bufferManager.writeIndexPage(pageIndexName, pageIndex, rows);
+        if (moreEntries)
+        {
+            pageIndexName = this->indexName + "_Overflow";
+            pageIndex = this->overflowCount++;
+        }
+        else
+        {
+            pageIndexName = this->indexName;
+            pageIndex = ++bucket + 1;
+        }
+        rows = {{-1}};
+    };
+
+    for (int pageCounter = 0; pageCounter < entries->blockCount; pageCounter++)
+    {
+        vector<vector<int>> entryRows = entries->readPage(pageCounter);
+        for (vector<int> &entry : entryRows)
+        {
+            while (entry[0] != bucket)
+                writePage(false);
+            if (rows.size() - 1 == this->bucketCapacity())
+                writePage(true);
+            rows.push_back({entry[1], entry[2], entry[3]});
+            this->entryCount++;
+        }
+    }
+    while (bucket < this->bucketCount())
+        writePage(false);
+    this->writeMeta();
+    logger.log("HashIndex::bulkLoad: " + to_string(this->bucketCount()) + " buckets, " +
+               to_string(this->overflowCount) + " overflow pages");
+}
+
+/**
+ * @brief Returns all the entries of bucket.
+ *
+ * @param bucket
+ * @return vector<vector<int>>
+ */
+vector<vector<int>> HashIndex::readBucket(uint bucket)
+{
+    logger.log("HashIndex::readBucket");
+    vector<vector<int>> entries;
+    vector<vector<int>> rows = bufferManager.getIndexPage(this->indexName, bucket + 1).rows;
+    while (true)
+    {
+        entries.insert(entries.end(), rows.begin() + 1, rows.end());
+        if (rows[0][0] == -1)
+            break;
+        rows = bufferManager.getIndexPage(this->indexName + "_Overflow", rows[0][0]).rows;
+    }
+    return entries;
+}
+
+/**
+ * @brief Returns the location {page, slot} of every row whose key is key.
+ *
+ * @param key
+ * @return vector<pair<int, int>>
+ */
+vector<pair<int, int>> HashIndex::find(int key)
+{
+    logger.log("HashIndex::find");
+    this->readMeta();
+    vector<pair<int, int>> locations;
+    vector<vector<int>> rows = bufferManager.getIndexPage(this->indexName, this->bucketOf(key) + 1).rows;
+    while (true)
+    {
+        for (int entryCounter = 1; entryCounter < rows.size(); entryCounter++)
+            if (rows[entryCounter][0] == key)
+                locations.emplace_back(rows[entryCounter][1], rows[entryCounter][2]);
+        if (rows[0][0] == -1)
+            break;
+        rows = bufferManager.getIndexPage(this->indexName + "_Overflow", rows[0][0]).rows;
+    }
+    return locations;
+}
+
+/**
+ * @brief Returns the locations {page, slot} of the rows of every key of keys,
+ * which must be distinct. The keys are grouped by bucket and the buckets
+ * probed in order, so every bucket is read once whatever the number of its
+ * keys.
+ *
+ * @param keys
+ * @return vector<vector<pair<int, int>>> locations of keys[i] at i
+ */
+vector<vector<pair<int, int>>> HashIndex::findKeys(const vector<int> &keys)
+{
+    logger.log("HashIndex::findKeys");
+    this->readMeta();
+    vector<vector<pair<int, int>>> locations(keys.size());
+    // {bucket, position in keys} of every key
+    vector<pair<uint, int>> probes;
+    for (int keyCounter = 0; keyCounter < keys.size(); keyCounter++)
+        probes.emplace_back(this->bucketOf(keys[keyCounter]), keyCounter);
+    sort(probes.begin(), probes.end());
+    for (int probeCounter = 0; probeCounter < probes.size();)
+    {
+        uint bucket = probes[probeCounter].first;
+        unordered_map<int, int> positions;
+        for (; probeCounter < probes.size() && probes[probeCounter].first == bucket; probeCounter++)
+            positions[keys[probes[probeCounter].second]] = probes[probeCounter].second;
+        for (vector<int> &entry : this->readBucket(bucket))
+        {
+            auto position = positions.find(entry[0]);
+            if (position != positions.end())
+                locations[position->second].emplace_back(entry[1], entry[2]);
+        }
+    }
+    return locations;
+}
+
+/**
+ * @brief Deletes every page of the index.
+ */
+void HashIndex::drop()
+{
+    logger.log("HashIndex::drop");
+    this->readMeta();
+    for (uint bucket = 0; bucket < this->bucketCount(); bucket++)
+        bufferManager.deleteIndexFile(this->indexName, bucket + 1);
+    for (uint pageCounter = 0; pageCounter < this->overflowCount; pageCounter++)
+        bufferManager.deleteIndexFile(this->indexName + "_Overflow", pageCounter);
+    bufferManager.deleteIndexFile(this->indexName, 0);
+}
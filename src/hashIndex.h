@@ -0,0 +1,49 @@
+#include "bTree.h"
+
+/**
+ * @brief The HashIndex is a linear hashing index on one column of a table,
+ * kept on disk like the BTree: every bucket is a chain of IndexPages read and
+ * written through the buffer manager. A point lookup reads the page 0 of the
+ * index and the pages of one bucket, usually a single page.
+ *
+ * <p>
+ * A bucket page starts with the header {next page of the bucket, or -1} and
+ * holds rows {key, page, slot} like a leaf of the BTree. The first page of
+ * bucket b is the page b + 1 of the index; pages that overflow a bucket are
+ * taken from a second set of pages named <index>_Overflow. Page 0 holds the
+ * state of the hash, {level, next bucket, overflow pages, entries}.
+ * </p>
+ *
+ * <p>
+ * With level l and next bucket n there are 2^l + n buckets, addressed as in
+ * linear hashing: a key goes to bucket hash mod 2^l, or to hash mod 2^(l + 1)
+ * when that bucket is below n. Tables are never appended to, so the index is
+ * not grown one split at a time: presize picks l and n from the number of
+ * entries so that they fill at most LOAD_FACTOR of the room in the buckets.
+ * </p>
+ */
+class HashIndex
+{
+    string indexName;
+    uint level = 0;
+    uint nextBucket = 0;
+    uint overflowCount = 0;
+    uint entryCount = 0;
+
+    static constexpr double LOAD_FACTOR = 0.8;
+
+    uint bucketCapacity();
+    uint bucketCount();
+    void readMeta();
+    void writeMeta();
+    vector<vector<int>> readBucket(uint bucket);
+
+public:
+    HashIndex(string indexName);
+    void presize(long long entryCount);
+    uint bucketOf(int key);
+    void bulkLoad(Table *entries);
+    vector<pair<int, int>> find(int key);
+    vector<vector<pair<int, int>>> findKeys(const vector<int> &keys);
+    void drop();
+};
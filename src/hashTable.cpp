@@ -0,0 +1,150 @@
+#include "global.h"
+
+/**
+ * @brief Construct a new HashTable object with room for expectedKeyCount
+ * distinct keys. The slot array is sized to the next power of two that keeps
+ * the load factor at or below one half.
+ *
+ * @param expectedKeyCount
+ */
+HashTable::HashTable(uint expectedKeyCount)
+{
+    logger.log("HashTable::HashTable");
+    uint capacity = 16;
+    this->shift = 28;
+    while (capacity < 2 * expectedKeyCount)
+    {
+        capacity <<= 1;
+        this->shift--;
+    }
+    this->mask = capacity - 1;
+    this->slotKeys.assign(capacity, 0);
+    this->slotHeads.assign(capacity, -1);
+    this->nextEntry.reserve(expectedKeyCount);
+}
+
+/**
+ * @brief Returns the slot holding key, or the empty slot where key would be
+ * inserted. Uses multiplicative (Fibonacci) hashing followed by linear probing.
+ *
+ * @param key
+ * @return uint
+ */
+uint HashTable::slotOf(int key)
+{
+    uint slot = ((uint)key * 2654435769u) >> this->shift;
+    while (this->slotHeads[slot] != -1 && this->slotKeys[slot] != key)
+        slot = (slot + 1) & this->mask;
+    return slot;
+}
+
+/**
+ * @brief Adds entry under key. Entries with the same key are returned by
+ * find/next in the reverse order of insertion.
+ *
+ * @param key
+ * @param entry non-negative identifier of the row, usually its position in the
+ * build relation
+ */
+void HashTable::insert(int key, int entry)
+{
+    uint slot = this->slotOf(key);
+    if (this->slotHeads[slot] == -1 && 2 * (this->keyCount + 1) > this->mask + 1)
+    {
+        this->grow();
+        slot = this->slotOf(key);
+    }
+    if (this->slotHeads[slot] == -1)
+        this->keyCount++;
+    if (entry >= (int)this->nextEntry.size())
+        this->nextEntry.resize(entry + 1, -1);
+    this->slotKeys[slot] = key;
+    this->nextEntry[entry] = this->slotHeads[slot];
+    this->slotHeads[slot] = entry;
+}
+
+/**
+ * @brief Doubles the slot array and re-inserts every key with its chain of
+ * entries.
+ */
+void HashTable::grow()
+{
+    logger.log("HashTable::grow");
+    vector<int> oldKeys = this->slotKeys;
+    vector<int> oldHeads = this->slotHeads;
+    this->mask = 2 * this->mask + 1;
+    this->shift--;
+    this->slotKeys.assign(this->mask + 1, 0);
+    this->slotHeads.assign(this->mask + 1, -1);
+    for (uint oldSlot = 0; oldSlot < oldHeads.size(); oldSlot++)
+    {
+        if (oldHeads[oldSlot] == -1)
+            continue;
+        uint slot = this->slotOf(oldKeys[oldSlot]);
+        this->slotKeys[slot] = oldKeys[oldSlot];
+        this->slotHeads[slot] = oldHeads[oldSlot];
+    }
+}
+
+/**
+ * @brief Returns the first entry stored under key or -1 if there is none.
+ *
+ * @param key
+ * @return int
+ */
+int HashTable::find(int key)
+{
+    return this->slotHeads[this->slotOf(key)];
+}
+
+/**
+ * @brief Returns the entry that follows entry under the same key or -1 once
+ * all of them have been visited.
+ *
+ * @param entry
+ * @return int
+ */
+int HashTable::next(int entry)
+{
+    return this->nextEntry[entry];
+}
+
+/**
+ * @brief Maps key to one of partitionCount partitions. Used to split relations
+ * that do not fit in memory; a different seed is used at every level of
+ * recursive partitioning so that a partition is split again rather than
+ * landing entirely in one sub-partition. The mixing function is unrelated to
+ * the one used for slots, so keys of one partition still spread over the
+ * whole slot array.
+ *
+ * @param key
+ * @param seed
+ * @param partitionCount
+ * @return uint
+ */
+uint HashTable::partitionOf(int key, int seed, uint partitionCount)
+{
+    uint hash = (uint)key ^ (0x9E3779B9u * (uint)(seed + 1));
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    hash ^= hash >> 16;
+    return hash % partitionCount;
+}
+
+/**
+ * @brief Hashes all the values of a row into a single key, so that whole rows
+ * can be stored in a HashTable. Rows with the same key still have to be
+ * compared to tell whether they are equal.
+ *
+ * @param row
+ * @return int
+ */
+int HashTable::hashRow(vector<int> &row)
+{
+    uint hash = 0;
+    for (int value : row)
+        hash = (hash ^ (uint)value) * 0x01000193u + 0x9E3779B9u;
+    return (int)hash;
+}
@@ -0,0 +1,36 @@
+#include "cursor.h"
+
+/**
+ * @brief The HashTable is the in-memory build side of a hash join. It maps an
+ * integer join key to the rows (identified by their position in the build
+ * relation) that carry that key. Keys live in a flat open-addressing array
+ * probed linearly so that a lookup touches consecutive memory, and rows that
+ * share a key are chained through a separate array instead of being stored in
+ * per-key containers.
+ *
+ * <p>
+ * The slot array doubles whenever it becomes half full, so the number of
+ * distinct keys given upfront is only a hint used to avoid rehashing.
+ * </p>
+ */
+class HashTable
+{
+    vector<int> slotKeys;
+    vector<int> slotHeads;
+    vector<int> nextEntry;
+    uint mask = 0;
+    uint shift = 0;
+    uint keyCount = 0;
+
+    uint slotOf(int key);
+    void grow();
+
+public:
+    HashTable(uint expectedKeyCount);
+    void insert(int key, int entry);
+    int find(int key);
+    int next(int entry);
+
+    static uint partitionOf(int key, int seed, uint partitionCount);
+    static int hashRow(vector<int> &row);
+};
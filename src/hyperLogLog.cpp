@@ -0,0 +1,57 @@
+#include "global.h"
+
+HyperLogLog::HyperLogLog()
+{
+    this->registers.assign(REGISTER_COUNT, 0);
+}
+
+uint64_t HyperLogLog::hashOf(int value)
+{
+    uint64_t hash = (uint32_t)value;
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/**
+ * @brief The register is picked by the high PRECISION bits of the hash and
+ * keeps the position of the first set bit among the others.
+ *
+ * @param value
+ */
+void HyperLogLog::add(int value)
+{
+    uint64_t hash = hashOf(value);
+    uint registerIndex = hash >> (64 - PRECISION);
+    // the guard bit bounds the run of zeros when the rest of the hash is 0
+    uint64_t rest = (hash << PRECISION) | (1ULL << (PRECISION - 1));
+    uint8_t rank = __builtin_clzll(rest) + 1;
+    if (rank > this->registers[registerIndex])
+        this->registers[registerIndex] = rank;
+}
+
+/**
+ * @brief The harmonic mean of 2^register over the registers, corrected by
+ * linear counting on the empty registers while few values have been added.
+ *
+ * @return long long the estimated number of distinct values
+ */
+long long HyperLogLog::estimate() const
+{
+    double sum = 0;
+    uint emptyRegisters = 0;
+    for (uint8_t rank : this->registers)
+    {
+        sum += ldexp(1.0, -rank);
+        if (rank == 0)
+            emptyRegisters++;
+    }
+    double alpha = 0.7213 / (1 + 1.079 / REGISTER_COUNT);
+    double estimate = alpha * REGISTER_COUNT * REGISTER_COUNT / sum;
+    if (estimate <= 2.5 * REGISTER_COUNT && emptyRegisters)
+        estimate = REGISTER_COUNT * log((double)REGISTER_COUNT / emptyRegisters);
+    return llround(estimate);
+}
@@ -33,14 +33,14 @@ Page::Page(string tableName, int pageIndex)
     this->tableName = tableName;
     this->pageIndex = pageIndex;
     this->pageName = "../data/temp/" + this->tableName + "_Page" + to_string(pageIndex);
-    Table table = *tableCatalogue.getTable(tableName);
-    this->columnCount = table.columnCount;
-    uint maxRowCount = table.maxRowsPerBlock;
+    Table *table = tableCatalogue.getTable(tableName);
+    this->columnCount = table->columnCount;
+    uint maxRowCount = table->maxRowsPerBlock;
     vector<int> row(columnCount, 0);
     this->rows.assign(maxRowCount, row);
 
     ifstream fin(pageName, ios::in);
-    this->rowCount = table.rowsPerBlockCount[pageIndex];
+    this->rowCount = table->rowsPerBlockCount[pageIndex];
     int number;
     for (uint rowCounter = 0; rowCounter < this->rowCount; rowCounter++)
     {
@@ -311,3 +311,74 @@ void MatrixPage::update_rows(vector<vector<int>> rows)
 {
     this->rows = rows;
 } 
+
+
+/**
+ * @brief Construct a new IndexPage object. Never used as part of the code
+ *
+ */
+IndexPage::IndexPage()
+{
+    this->pageName = "";
+    this->indexName = "";
+    this->pageIndex = -1;
+    this->rows.clear();
+}
+
+/**
+ * @brief Construct a new IndexPage object by reading the page pageIndex of
+ * the index indexName from its file.
+ *
+ * @param indexName 
+ * @param pageIndex 
+ */
+IndexPage::IndexPage(string indexName, int pageIndex)
+{
+    logger.log("IndexPage::IndexPage");
+    this->indexName = indexName;
+    this->pageIndex = pageIndex;
+    this->pageName = "../data/index/" + this->indexName + "_IndexPage" + to_string(pageIndex);
+
+    ifstream fin(pageName, ios::in);
+    string line;
+    int number;
+    while (getline(fin, line))
+    {
+        stringstream s(line);
+        vector<int> row;
+        while (s >> number)
+            row.push_back(number);
+        this->rows.push_back(row);
+    }
+    fin.close();
+}
+
+IndexPage::IndexPage(string indexName, int pageIndex, vector<vector<int>> rows)
+{
+    logger.log("IndexPage::IndexPage");
+    this->indexName = indexName;
+    this->pageIndex = pageIndex;
+    this->rows = rows;
+    this->pageName = "../data/index/" + this->indexName + "_IndexPage" + to_string(pageIndex);
+}
+
+/**
+ * @brief writes current page contents to file.
+ * 
+ */
+void IndexPage::writePage()
+{
+    logger.log("IndexPage::writePage");
+    ofstream fout(this->pageName, ios::trunc);
+    for (vector<int> &row : this->rows)
+    {
+        for (int columnCounter = 0; columnCounter < row.size(); columnCounter++)
+        {
+            if (columnCounter != 0)
+                fout << " ";
+            fout << row[columnCounter];
+        }
+        fout << endl;
+    }
+    fout.close();
+}
@@ -48,3 +48,24 @@ public:
 
   void update_rows(vector<vector<int>> rows);
 };
+
+/**
+ * @brief An IndexPage is a page of an index, such as a node of a B+ tree. Its
+ * rows may differ in length, so unlike a Page it is read back without looking
+ * its owner up in a catalogue. The page is stored in the file
+ * "../data/index/<indexName>_IndexPage<pageIndex>", one row per line. Unlike
+ * the temp directory the index directory is kept across restarts.
+ */
+class IndexPage {
+
+  string indexName;
+  int pageIndex;
+
+public:
+  string pageName = "";
+  vector<vector<int>> rows;
+  IndexPage();
+  IndexPage(string indexName, int pageIndex);
+  IndexPage(string indexName, int pageIndex, vector<vector<int>> rows);
+  void writePage();
+};
@@ -0,0 +1,326 @@
+#include "global.h"
+
+/**
+ * @brief Returns the low 16 bits of the numbers of container in increasing
+ * order, whatever its form.
+ *
+ * @param container
+ * @return vector<uint16_t>
+ */
+vector<uint16_t> RoaringBitmap::lowValues(const Container &container)
+{
+    if (container.type == ARRAY)
+        return container.values;
+    vector<uint16_t> values;
+    values.reserve(container.cardinality);
+    if (container.type == RUNS)
+    {
+        for (const pair<uint16_t, uint16_t> &run : container.runs)
+            for (uint value = run.first; value <= (uint)run.first + run.second; value++)
+                values.push_back(value);
+        return values;
+    }
+    for (uint wordCounter = 0; wordCounter < WORD_COUNT; wordCounter++)
+        for (uint64_t word = container.words[wordCounter]; word; word &= word - 1)
+            values.push_back(wordCounter * 64 + __builtin_ctzll(word));
+    return values;
+}
+
+/**
+ * @brief Returns container in the bitmap form, as WORD_COUNT words of 64 bits.
+ *
+ * @param container
+ * @return vector<uint64_t>
+ */
+vector<uint64_t> RoaringBitmap::wordsOf(const Container &container)
+{
+    if (container.type == WORDS)
+        return container.words;
+    vector<uint64_t> words(WORD_COUNT, 0);
+    for (uint16_t value : lowValues(container))
+        words[value >> 6] |= 1ULL << (value & 63);
+    return words;
+}
+
+/**
+ * @brief Makes words the contents of container and gives it its smallest form.
+ *
+ * @param container
+ * @param words
+ */
+void RoaringBitmap::fromWords(Container &container, vector<uint64_t> &words)
+{
+    container.type = WORDS;
+    container.cardinality = 0;
+    for (uint64_t word : words)
+        container.cardinality += __builtin_popcountll(word);
+    container.words.swap(words);
+    optimize(container);
+}
+
+/**
+ * @brief Gives container the smallest of the three forms: 2 bytes a number
+ * for an array, 4 bytes a run, or 8 KB for the bitmap. An array is only
+ * kept up to ARRAY_LIMIT numbers, where the bitmap becomes smaller.
+ *
+ * @param container
+ */
+void RoaringBitmap::optimize(Container &container)
+{
+    vector<uint16_t> values = lowValues(container);
+    uint runCount = 0;
+    for (uint valueCounter = 0; valueCounter < values.size(); valueCounter++)
+        if (valueCounter == 0 || values[valueCounter] != values[valueCounter - 1] + 1)
+            runCount++;
+    uint arraySize = values.size() <= ARRAY_LIMIT ? 2 * values.size() : UINT_MAX;
+    uint wordsSize = WORD_COUNT * 8;
+    uint runsSize = 4 * runCount;
+
+    container.values.clear();
+    container.words.clear();
+    container.runs.clear();
+    if (runsSize < min(arraySize, wordsSize))
+    {
+        container.type = RUNS;
+        for (uint valueCounter = 0; valueCounter < values.size(); valueCounter++)
+            if (valueCounter == 0 || values[valueCounter] != values[valueCounter - 1] + 1)
+                container.runs.emplace_back(values[valueCounter], 0);
+            else
+                container.runs.back().second++;
+    }
+    else if (arraySize <= wordsSize)
+    {
+        container.type = ARRAY;
+        container.values.swap(values);
+    }
+    else
+    {
+        container.type = WORDS;
+        container.words.assign(WORD_COUNT, 0);
+        for (uint16_t value : values)
+            container.words[value >> 6] |= 1ULL << (value & 63);
+    }
+}
+
+/**
+ * @brief Adds value to the set. Values must be added in increasing order; the
+ * containers are filled as arrays that turn into bitmaps when they pass
+ * ARRAY_LIMIT, and optimize is meant to be called once all are added.
+ *
+ * @param value
+ */
+void RoaringBitmap::add(uint value)
+{
+    uint16_t key = value >> 16;
+    uint16_t low = value & 0xFFFF;
+    if (this->containers.empty() || this->containers.back().key != key)
+    {
+        this->containers.emplace_back();
+        this->containers.back().key = key;
+    }
+    Container &container = this->containers.back();
+    if (container.type == ARRAY)
+    {
+        container.values.push_back(low);
+        if (container.values.size() > ARRAY_LIMIT)
+        {
+            container.words = wordsOf(container);
+            container.values.clear();
+            container.type = WORDS;
+        }
+    }
+    else
+        container.words[low >> 6] |= 1ULL << (low & 63);
+    container.cardinality++;
+}
+
+void RoaringBitmap::optimize()
+{
+    for (Container &container : this->containers)
+        optimize(container);
+}
+
+uint RoaringBitmap::cardinality()
+{
+    uint cardinality = 0;
+    for (Container &container : this->containers)
+        cardinality += container.cardinality;
+    return cardinality;
+}
+
+/**
+ * @brief Returns the numbers in the set in increasing order.
+ *
+ * @return vector<uint>
+ */
+vector<uint> RoaringBitmap::values()
+{
+    vector<uint> values;
+    values.reserve(this->cardinality());
+    for (Container &container : this->containers)
+        for (uint16_t low : lowValues(container))
+            values.push_back((uint)container.key << 16 | low);
+    return values;
+}
+
+/**
+ * @brief Returns the numbers that are in both bitmap1 and bitmap2.
+ *
+ * @param bitmap1
+ * @param bitmap2
+ * @return RoaringBitmap
+ */
+RoaringBitmap RoaringBitmap::intersect(RoaringBitmap &bitmap1, RoaringBitmap &bitmap2)
+{
+    RoaringBitmap result;
+    vector<Container> &containers1 = bitmap1.containers, &containers2 = bitmap2.containers;
+    for (uint counter1 = 0, counter2 = 0; counter1 < containers1.size() && counter2 < containers2.size();)
+    {
+        if (containers1[counter1].key != containers2[counter2].key)
+        {
+            (containers1[counter1].key < containers2[counter2].key ? counter1 : counter2)++;
+            continue;
+        }
+        Container &container1 = containers1[counter1++], &container2 = containers2[counter2++];
+        Container container;
+        container.key = container1.key;
+        if (container1.type == ARRAY && container2.type == ARRAY)
+        {
+            set_intersection(container1.values.begin(), container1.values.end(),
+                             container2.values.begin(), container2.values.end(),
+                             back_inserter(container.values));
+            container.cardinality = container.values.size();
+        }
+        else
+        {
+            vector<uint64_t> words = wordsOf(container1), words2 = wordsOf(container2);
+            for (uint wordCounter = 0; wordCounter < WORD_COUNT; wordCounter++)
+                words[wordCounter] &= words2[wordCounter];
+            fromWords(container, words);
+        }
+        if (container.cardinality)
+            result.containers.push_back(container);
+    }
+    return result;
+}
+
+/**
+ * @brief Returns the numbers that are in bitmap1 or bitmap2.
+ *
+ * @param bitmap1
+ * @param bitmap2
+ * @return RoaringBitmap
+ */
+RoaringBitmap RoaringBitmap::unite(RoaringBitmap &bitmap1, RoaringBitmap &bitmap2)
+{
+    RoaringBitmap result;
+    vector<Container> &containers1 = bitmap1.containers, &containers2 = bitmap2.containers;
+    uint counter1 = 0, counter2 = 0;
+    while (counter1 < containers1.size() || counter2 < containers2.size())
+    {
+        if (counter2 == containers2.size() ||
+            (counter1 < containers1.size() && containers1[counter1].key < containers2[counter2].key))
+        {
+            result.containers.push_back(containers1[counter1++]);
+            continue;
+        }
+        if (counter1 == containers1.size() || containers2[counter2].key < containers1[counter1].key)
+        {
+            result.containers.push_back(containers2[counter2++]);
+            continue;
+        }
+        Container &container1 = containers1[counter1++], &container2 = containers2[counter2++];
+        Container container;
+        container.key = container1.key;
+        if (container1.type == ARRAY && container2.type == ARRAY)
+        {
+            set_union(container1.values.begin(), container1.values.end(),
+                      container2.values.begin(), container2.values.end(),
+                      back_inserter(container.values));
+            container.cardinality = container.values.size();
+            optimize(container);
+        }
+        else
+        {
+            vector<uint64_t> words = wordsOf(container1), words2 = wordsOf(container2);
+            for (uint wordCounter = 0; wordCounter < WORD_COUNT; wordCounter++)
+                words[wordCounter] |= words2[wordCounter];
+            fromWords(container, words);
+        }
+        result.containers.push_back(container);
+    }
+    return result;
+}
+
+/**
+ * @brief Writes the bitmap as ints: the number of containers, then for every
+ * container {key, form, size} followed by its contents. An array is stored
+ * two numbers to an int, a bitmap as 2 ints per word and a run as one int
+ * {start | (length - 1) << 16}. size is the count of numbers, or of runs.
+ *
+ * @return vector<int>
+ */
+vector<int> RoaringBitmap::serialize()
+{
+    vector<int> ints = {(int)this->containers.size()};
+    for (Container &container : this->containers)
+    {
+        uint size = container.type == RUNS ? container.runs.size() : container.cardinality;
+        ints.insert(ints.end(), {container.key, container.type, (int)size});
+        if (container.type == ARRAY)
+            for (uint valueCounter = 0; valueCounter < size; valueCounter += 2)
+                ints.push_back(container.values[valueCounter] |
+                               (valueCounter + 1 < size ? (uint)container.values[valueCounter + 1] << 16 : 0));
+        else if (container.type == WORDS)
+            for (uint64_t word : container.words)
+                ints.insert(ints.end(), {(int)(uint32_t)word, (int)(uint32_t)(word >> 32)});
+        else
+            for (pair<uint16_t, uint16_t> &run : container.runs)
+                ints.push_back(run.first | (uint)run.second << 16);
+    }
+    return ints;
+}
+
+/**
+ * @brief Reads back a bitmap written by serialize.
+ *
+ * @param ints
+ * @return RoaringBitmap
+ */
+RoaringBitmap RoaringBitmap::deserialize(const vector<int> &ints)
+{
+    RoaringBitmap bitmap;
+    uint position = 0;
+    uint containerCount = ints.empty() ? 0 : ints[position++];
+    for (uint containerCounter = 0; containerCounter < containerCount; containerCounter++)
+    {
+        Container container;
+        container.key = ints[position++];
+        container.type = (ContainerType)ints[position++];
+        uint size = ints[position++];
+        if (container.type == ARRAY)
+        {
+            for (uint valueCounter = 0; valueCounter < size; valueCounter++)
+                container.values.push_back((uint)ints[position + valueCounter / 2] >> (valueCounter % 2 * 16));
+            position += (size + 1) / 2;
+            container.cardinality = size;
+        }
+        else if (container.type == WORDS)
+        {
+            for (uint wordCounter = 0; wordCounter < WORD_COUNT; wordCounter++, position += 2)
+                container.words.push_back((uint32_t)ints[position] | (uint64_t)(uint32_t)ints[position + 1] << 32);
+            container.cardinality = size;
+        }
+        else
+        {
+            for (uint runCounter = 0; runCounter < size; runCounter++)
+            {
+                uint run = ints[position++];
+                container.runs.emplace_back(run & 0xFFFF, run >> 16);
+                container.cardinality += (run >> 16) + 1;
+            }
+        }
+        bitmap.containers.push_back(container);
+    }
+    return bitmap;
+}
@@ -0,0 +1,58 @@
+#include "hashIndex.h"
+
+/**
+ * @brief The RoaringBitmap is a compressed set of row numbers. The numbers are
+ * split on their high 16 bits into containers, and a container holds the low
+ * 16 bits of its numbers in whichever of three forms is smallest: a sorted
+ * array of 2 bytes per number, a bitmap of 2^16 bits (8 KB whatever the
+ * count) or a list of runs of consecutive numbers. Rows of one value in a
+ * sorted table are a single run per container.
+ *
+ * <p>
+ * AND and OR go container by container over the containers with the same
+ * high bits. Two arrays are merged directly, anything else goes through the
+ * bitmap form, a word at a time, and the result takes its smallest form
+ * again. serialize turns the bitmap into ints so that it can be stored in
+ * IndexPages.
+ * </p>
+ */
+class RoaringBitmap
+{
+    enum ContainerType
+    {
+        ARRAY,
+        WORDS,
+        RUNS
+    };
+
+    struct Container
+    {
+        uint16_t key = 0;
+        ContainerType type = ARRAY;
+        uint cardinality = 0;
+        vector<uint16_t> values;
+        vector<uint64_t> words;
+        // {start, length - 1} of every run
+        vector<pair<uint16_t, uint16_t>> runs;
+    };
+
+    vector<Container> containers;
+
+    static const uint ARRAY_LIMIT = 4096;
+    static const uint WORD_COUNT = 1024;
+
+    static vector<uint16_t> lowValues(const Container &container);
+    static vector<uint64_t> wordsOf(const Container &container);
+    static void fromWords(Container &container, vector<uint64_t> &words);
+    static void optimize(Container &container);
+
+public:
+    void add(uint value);
+    void optimize();
+    uint cardinality();
+    vector<uint> values();
+    static RoaringBitmap intersect(RoaringBitmap &bitmap1, RoaringBitmap &bitmap2);
+    static RoaringBitmap unite(RoaringBitmap &bitmap1, RoaringBitmap &bitmap2);
+    vector<int> serialize();
+    static RoaringBitmap deserialize(const vector<int> &ints);
+};
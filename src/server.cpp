@@ -8,17 +8,23 @@ uint BLOCK_COUNT = 10;
 uint PRINT_COUNT = 20;
 uint blockReadCounter = 0;
 uint blockWriteCounter = 0;
+uint mergePassCounter = 0;
 
 Logger logger;
 vector<string> tokenizedQuery;
 ParsedQuery parsedQuery;
+// the catalogues unload their tables through the buffer manager when they
+// are destroyed, so it has to be constructed before (and destroyed after) them
+BufferManager bufferManager;
 TableCatalogue tableCatalogue;
 MatrixCatalogue matrixCatalogue;
-BufferManager bufferManager;
 
 void doCommand()
 {
     logger.log("doCommand");
+    blockReadCounter = 0;
+    blockWriteCounter = 0;
+    mergePassCounter = 0;
     if (syntacticParse() && semanticParse())
         executeCommand();
     return;
@@ -31,6 +37,7 @@ int main(void)
     string command;
     system("rm -rf ../data/temp");
     system("mkdir ../data/temp");
+    system("mkdir -p ../data/index");
 
     while(!cin.eof())
     {
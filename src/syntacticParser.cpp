@@ -91,6 +91,7 @@ void ParsedQuery::clear()
     this->indexingStrategy = NOTHING;
     this->indexColumnName = "";
     this->indexRelationName = "";
+    this->indexIncludedColumns.clear();
 
     this->joinBinaryOperator = NO_BINOP_CLAUSE;
     this->joinResultRelationName = "";
@@ -118,12 +119,29 @@ void ParsedQuery::clear()
     this->selectionFirstColumnName = "";
     this->selectionSecondColumnName = "";
     this->selectionIntLiteral = 0;
+    this->selectionEqualities.clear();
 
     this->sortingStrategy.clear();
     // this->sortResultRelationName = "";
     this->sortColumnNames.clear();
     this->sortRelationName ="";
 
+    this->orderbyColumnName = "";
+    this->orderbyResultRelationName = "";
+    this->orderbyRelationName = "";
+    this->orderbySortingStrategy = ASC;
+    this->orderbyLimit = -1;
+
+    this->groupbyResultRelationName = "";
+    this->groupbyColumnNames.clear();
+    this->groupbyRelationName = "";
+    this->groupbyHavingFunction = "";
+    this->groupbyHavingColumnName = "";
+    this->groupbyConditionValue = 0;
+    this->groupbyBinaryOperator = NO_BINOP_CLAUSE;
+    this->groupbyReturnFunctions.clear();
+    this->groupbyReturnColumnNames.clear();
+
     this->sourceFileName = "";
 }
 
@@ -79,6 +79,7 @@ public:
     IndexingStrategy indexingStrategy = NOTHING;
     string indexColumnName = "";
     string indexRelationName = "";
+    vector<string> indexIncludedColumns;
 
     BinaryOperator joinBinaryOperator = NO_BINOP_CLAUSE;
     string joinResultRelationName = "";
@@ -110,6 +111,9 @@ public:
     string selectionFirstColumnName = "";
     string selectionSecondColumnName = "";
     int selectionIntLiteral = 0;
+    // column == int_literal conditions joined by AND and OR, kept as an OR of
+    // ANDs; empty for a single condition
+    vector<vector<pair<string, int>>> selectionEqualities;
 
     // SortingStrategy sortingStrategy = NO_SORT_CLAUSE;
     vector<SortingStrategy> sortingStrategy;
@@ -119,17 +123,20 @@ public:
     string sortRelationName = "";
 
     string groupbyResultRelationName = "";
-    string groupbyColumnName = "";
+    vector<string> groupbyColumnNames;
     string groupbyRelationName = "";
-    string groupbyGroupingColumnName = "";
-    int groupbyConditionValue = 0;
-    string groupbyAggregateFunc1 = "";
-    string groupbyAggregateFunc2 = "";
+    string groupbyHavingFunction = "";
+    string groupbyHavingColumnName = "";
+    long long groupbyConditionValue = 0;
     BinaryOperator groupbyBinaryOperator = NO_BINOP_CLAUSE;
+    vector<string> groupbyReturnFunctions;
+    vector<string> groupbyReturnColumnNames;
 
     string orderbyColumnName = "";
     string orderbyResultRelationName = "";
     string orderbyRelationName = "";
+    SortingStrategy orderbySortingStrategy = ASC;
+    long long orderbyLimit = -1;
 
     string sourceFileName = "";
 
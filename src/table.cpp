@@ -56,9 +56,14 @@ bool Table::load() {
   string line;
   if (getline(fin, line)) {
     fin.close();
-    if (this->extractColumnNames(line))
-      if (this->blockify())
+    if (this->extractColumnNames(line)) {
+      // Bloom filters listed in the catalogue are built again by blockify
+      this->openIndexCatalogue();
+      if (this->blockify()) {
+        this->pagesMatchSource = true;
         return true;
+      }
+    }
   }
   fin.close();
   return false;
@@ -107,10 +112,7 @@ bool Table::blockify() {
   vector<int> row(this->columnCount, 0);
   vector<vector<int>> rowsInPage(this->maxRowsPerBlock, row);
   int pageCounter = 0;
-  unordered_set<int> dummy;
-  dummy.clear();
-  this->distinctValuesInColumns.assign(this->columnCount, dummy);
-  this->distinctValuesPerColumnCount.assign(this->columnCount, 0);
+  this->distinctValueSketches.assign(this->columnCount, HyperLogLog());
   getline(fin, line);
   // cout << "Line: " << line << endl;
   while (getline(fin, line)) {
@@ -134,6 +136,7 @@ bool Table::blockify() {
     if (pageCounter == this->maxRowsPerBlock) {
       bufferManager.writePage(this->tableName, this->blockCount, rowsInPage,
                               pageCounter);
+      this->updateBloomFilters(this->blockCount, rowsInPage, pageCounter);
       this->blockCount++;
       this->rowsPerBlockCount.emplace_back(pageCounter);
       pageCounter = 0;
@@ -142,35 +145,39 @@ bool Table::blockify() {
   if (pageCounter) {
     bufferManager.writePage(this->tableName, this->blockCount, rowsInPage,
                             pageCounter);
+    this->updateBloomFilters(this->blockCount, rowsInPage, pageCounter);
     this->blockCount++;
     this->rowsPerBlockCount.emplace_back(pageCounter);
     pageCounter = 0;
   }
 
-  if (this->rowCount == 0)
+  if (this->rowCount == 0) {
+    this->distinctValueSketches.clear();
     return false;
-  this->distinctValuesInColumns.clear();
+  }
+  this->distinctValuesPerColumnCount.assign(this->columnCount, 0);
+  for (int columnCounter = 0; columnCounter < this->columnCount;
+       columnCounter++)
+    this->distinctValuesPerColumnCount[columnCounter] =
+        min(this->distinctValueSketches[columnCounter].estimate(),
+            this->rowCount);
+  this->distinctValueSketches.clear();
   return true;
 }
 
 /**
  * @brief Given a row of values, this function will update the statistics it
  * stores i.e. it updates the number of rows that are present in the column and
- * the number of distinct values present in each column. These statistics are to
- * be used during optimisation.
+ * the sketch of the distinct values present in each column. These statistics
+ * are to be used during optimisation.
  *
  * @param row
  */
-void Table::updateStatistics(vector<int> row) {
+void Table::updateStatistics(vector<int> &row) {
   this->rowCount++;
   for (int columnCounter = 0; columnCounter < this->columnCount;
-       columnCounter++) {
-    if (!this->distinctValuesInColumns[columnCounter].count(
-            row[columnCounter])) {
-      this->distinctValuesInColumns[columnCounter].insert(row[columnCounter]);
-      this->distinctValuesPerColumnCount[columnCounter]++;
-    }
-  }
+       columnCounter++)
+    this->distinctValueSketches[columnCounter].add(row[columnCounter]);
 }
 
 /**
@@ -207,6 +214,14 @@ void Table::renameColumn(string fromColumnName, string toColumnName) {
       break;
     }
   }
+  replace(this->sortedColumns.begin(), this->sortedColumns.end(), fromColumnName, toColumnName);
+  // index files are named after the column position, so they stay where they are
+  if (this->indexedColumn == fromColumnName)
+    this->indexedColumn = toColumnName;
+  replace(this->includedColumns.begin(), this->includedColumns.end(), fromColumnName, toColumnName);
+  replace(this->bitmapIndexedColumns.begin(), this->bitmapIndexedColumns.end(), fromColumnName,
+          toColumnName);
+  replace(this->bloomColumns.begin(), this->bloomColumns.end(), fromColumnName, toColumnName);
   return;
 }
 
@@ -273,6 +288,8 @@ void Table::makePermanent() {
     this->writeRow(row, fout);
   }
   fout.close();
+  this->pagesMatchSource = true;
+  this->saveIndexCatalogue();
 }
 
 /**
@@ -290,13 +307,18 @@ bool Table::isPermanent() {
 
 /**
  * @brief The unload function removes the table from the database by deleting
- * all temporary files created as part of this table
+ * all temporary files created as part of this table. Its indexes are kept
+ * when they are still valid for its source file, see saveIndexCatalogue.
  *
  */
 void Table::unload() {
   logger.log("Table::~unload");
-  for (int pageCounter = 0; pageCounter < this->blockCount; pageCounter++)
+  if (!this->pagesMatchSource)
+    this->dropIndexes();
+  for (int pageCounter = 0; pageCounter < this->blockCount; pageCounter++) {
+    bufferManager.removeFromPool(this->tableName, pageCounter);
     bufferManager.deleteFile(this->tableName, pageCounter);
+  }
   if (!isPermanent())
     bufferManager.deleteFile(this->sourceFileName);
 }
@@ -311,6 +333,23 @@ Cursor Table::getCursor() {
   Cursor cursor(this->tableName, 0);
   return cursor;
 }
+/**
+ * @brief Function that reads every row of the page indicated by pageIndex
+ * through the buffer manager. Used by operators that hold whole pages in
+ * memory rather than streaming rows through a cursor.
+ *
+ * @param pageIndex
+ * @return vector<vector<int>>
+ */
+vector<vector<int>> Table::readPage(int pageIndex) {
+  logger.log("Table::readPage");
+  Page page = bufferManager.getPage(this->tableName, pageIndex);
+  vector<vector<int>> rows(this->rowsPerBlockCount[pageIndex]);
+  for (int rowCounter = 0; rowCounter < (int)rows.size(); rowCounter++)
+    rows[rowCounter] = page.getRow(rowCounter);
+  return rows;
+}
+
 /**
  * @brief Function that returns the index of column indicated by columnName.
  *        Assumes that the columnName is valid
@@ -328,603 +367,2240 @@ int Table::getColumnIndex(string columnName) {
   logger.log("Table::getColumnIndex got incorrect columnName: " + columnName);
 }
 
-void Table::merge(vector<string> sortColumnNames, vector<int> sortingStrategy, 
-    vector<Cursor> blockCursors, int round, int setCount) {
-
-      logger.log("Table::merge");
-  auto compare = [this, &sortColumnNames, &sortingStrategy](
-                     pair<vector<int>, int> &X, pair<vector<int>, int> &Y) {
-    // check in the order of the column names
-    vector<int> A = X.first;
-    vector<int> B = Y.first;
-    for (int idx = 0; idx < sortColumnNames.size(); ++idx) {
-      int colIdx = this->getColumnIndex(sortColumnNames[idx]);
-      if (A[colIdx] != B[colIdx]) {
-        if (sortingStrategy[idx] == ASC) {
-          return A[colIdx] > B[colIdx];
-        } else {
-          return A[colIdx] < B[colIdx];
-        }
+/**
+ * @brief Encodes the values of row in columnIndices into a key whose bytes
+ * compare (as with memcmp) in the order the rows are to be sorted. Every
+ * value takes 4 big-endian bytes with the sign bit flipped, so that negative
+ * values come first, and the bytes are complemented for DESC columns. Sorting
+ * then needs no knowledge of columns or directions.
+ *
+ * @param row
+ * @param columnIndices
+ * @param sortingStrategy ASC or DESC for each of columnIndices
+ * @return string
+ */
+string Table::sortKey(const vector<int> &row, const vector<int> &columnIndices,
+                      const vector<int> &sortingStrategy) {
+  string key(4 * columnIndices.size(), '\0');
+  for (int idx = 0; idx < (int)columnIndices.size(); idx++) {
+    uint value = (uint)row[columnIndices[idx]] ^ 0x80000000u;
+    if (sortingStrategy[idx] == DESC)
+      value = ~value;
+    for (int byte = 0; byte < 4; byte++)
+      key[4 * idx + byte] = (char)(value >> (24 - 8 * byte));
+  }
+  return key;
+}
+
+/**
+ * @brief Stable LSD radix sort of rows on the values in columnIndices, in the
+ * order given by sortingStrategy. The values are normalized as in sortKey and
+ * packed two columns to a 64 bit key, the pair of least significant columns
+ * being sorted first. Every pass distributes the rows on one byte of the key,
+ * so sorting takes O(n) time per key byte with no comparisons, and a pass is
+ * skipped when all the rows share that byte (as with small values).
+ *
+ * @tparam T int for table rows, long long for groups whose values are ints
+ * @param rows
+ * @param columnIndices
+ * @param sortingStrategy ASC or DESC for each of columnIndices
+ */
+template <typename T>
+void Table::radixSortRows(vector<vector<T>> &rows, const vector<int> &columnIndices,
+                          const vector<int> &sortingStrategy) {
+  uint rowCount = rows.size();
+  if (rowCount < 2)
+    return;
+  vector<uint> order(rowCount), orderBuffer(rowCount);
+  iota(order.begin(), order.end(), 0);
+  vector<unsigned long long> keys(rowCount), keyBuffer(rowCount);
+  for (int last = columnIndices.size(); last > 0; last -= 2) {
+    int first = max(0, last - 2);
+    for (uint rowCounter = 0; rowCounter < rowCount; rowCounter++) {
+      unsigned long long key = 0;
+      for (int idx = first; idx < last; idx++) {
+        uint value = (uint)(int)rows[order[rowCounter]][columnIndices[idx]] ^ 0x80000000u;
+        if (sortingStrategy[idx] == DESC)
+          value = ~value;
+        key = key << 32 | value;
       }
+      keys[rowCounter] = key;
+    }
+    for (int shift = 0; shift < 32 * (last - first); shift += 8) {
+      uint counts[257] = {0};
+      for (uint rowCounter = 0; rowCounter < rowCount; rowCounter++)
+        counts[((keys[rowCounter] >> shift) & 255) + 1]++;
+      if (counts[((keys[0] >> shift) & 255) + 1] == rowCount)
+        continue;
+      for (int digit = 0; digit < 256; digit++)
+        counts[digit + 1] += counts[digit];
+      for (uint rowCounter = 0; rowCounter < rowCount; rowCounter++) {
+        uint position = counts[(keys[rowCounter] >> shift) & 255]++;
+        keyBuffer[position] = keys[rowCounter];
+        orderBuffer[position] = order[rowCounter];
+      }
+      keys.swap(keyBuffer);
+      order.swap(orderBuffer);
+    }
+  }
+  vector<vector<T>> sortedRows(rowCount);
+  for (uint rowCounter = 0; rowCounter < rowCount; rowCounter++)
+    sortedRows[rowCounter].swap(rows[order[rowCounter]]);
+  rows.swap(sortedRows);
+}
+
+/**
+ * @brief Sorts rows in memory on sortColumnNames, in the order given by
+ * sortingStrategy (ASC or DESC per column), using radixSortRows. The sort is
+ * stable.
+ *
+ * @param rows
+ * @param sortColumnNames
+ * @param sortingStrategy
+ */
+void Table::sortRows(vector<vector<int>> &rows, vector<string> sortColumnNames,
+                     vector<int> sortingStrategy) {
+  logger.log("Table::sortRows");
+  vector<int> columnIndices;
+  for (string &columnName : sortColumnNames)
+    columnIndices.push_back(this->getColumnIndex(columnName));
+  radixSortRows(rows, columnIndices, sortingStrategy);
+}
+
+/**
+ * @brief Merges the sorted runs into resultantTable. The heap holds the
+ * sortKey of the next row of every run, so comparisons are plain byte
+ * comparisons. Every run is double buffered: while the rows of its current
+ * page are being merged, its next page is already being read in the
+ * background, so the merge rarely waits for the disk. The pages are read by
+ * one reader thread for the whole merge, which takes the requests of the runs
+ * from a queue in order. Rows that compare equal
+ * are taken from the runs in the order given, so merging is stable. If
+ * distinct is set, a row identical to the previous output row is dropped; this
+ * requires the runs to be sorted on every column.
+ *
+ * Only the rows whose key lies in [lowKey, highKey) are merged, an empty
+ * string leaving that side unbounded. Every run is entered at lowKey by a
+ * binary search over its pages, so that the merges of disjoint key ranges can
+ * share the same runs.
+ *
+ * @param sortColumnNames
+ * @param sortingStrategy
+ * @param runs the input runs
+ * @param resultantTable empty table, already in the catalogue
+ * @param distinct
+ * @param lowKey
+ * @param highKey
+ */
+void Table::merge(vector<string> sortColumnNames, vector<int> sortingStrategy,
+    vector<Table*> runs, Table* resultantTable, bool distinct, string lowKey, string highKey) {
+  logger.log("Table::merge");
+  vector<int> columnIndices;
+  for (string &columnName : sortColumnNames)
+    columnIndices.push_back(this->getColumnIndex(columnName));
+
+  // the page of every run being merged, the position in it and the read of
+  // the page that follows
+  int runCount = runs.size();
+  vector<vector<vector<int>>> currentPages(runCount);
+  vector<int> nextRows(runCount, 0);
+  vector<uint> nextPages(runCount, 0);
+  vector<future<vector<vector<int>>>> prefetches(runCount);
+  // {run, page, promise of its rows} of the pages still to be read
+  typedef tuple<Table*, uint, promise<vector<vector<int>>>> PageRequest;
+  deque<PageRequest> requests;
+  mutex requestMutex;
+  condition_variable requestReady;
+  bool merged = false;
+  thread reader([&]() {
+    while (true) {
+      unique_lock<mutex> lock(requestMutex);
+      requestReady.wait(lock, [&]() { return merged || !requests.empty(); });
+      if (requests.empty())
+        return;
+      PageRequest request = move(requests.front());
+      requests.pop_front();
+      lock.unlock();
+      get<2>(request).set_value(get<0>(request)->readPage(get<1>(request)));
     }
+  });
+  auto prefetch = [&](int idx) {
+    Table* run = runs[idx];
+    uint pageIndex = nextPages[idx]++;
+    if (pageIndex >= run->blockCount)
+      return;
+    promise<vector<vector<int>>> rows;
+    prefetches[idx] = rows.get_future();
+    lock_guard<mutex> lock(requestMutex);
+    requests.emplace_back(run, pageIndex, move(rows));
+    requestReady.notify_one();
+  };
+  // moves run idx to its next page, returning false once it is exhausted
+  auto advance = [&](int idx) {
+    if (!prefetches[idx].valid())
+      return false;
+    currentPages[idx] = prefetches[idx].get();
+    nextRows[idx] = 0;
+    prefetch(idx);
     return true;
   };
+  auto keyOf = [&](int idx) {
+    return sortKey(currentPages[idx][nextRows[idx]], columnIndices, sortingStrategy);
+  };
 
-
-  // initialize a priority queue with the first row from each block
-  priority_queue<pair<vector<int>, int>, vector<pair<vector<int>, int>>,
-                 decltype(compare)>
-      min_heap(compare);
-  for (int idx = 0; idx < blockCursors.size(); ++idx) {
-    vector<int> row = blockCursors[idx].getNext();
-    // for(int &n: row) {
-    //   cout << n << " ";
-    // }
-    // cout << "\n";
-    min_heap.push({row, idx});
+  // initialize a priority queue with the key of the first row of each run and
+  // the run it comes from, which also breaks ties
+  priority_queue<pair<string, int>, vector<pair<string, int>>, greater<pair<string, int>>> min_heap;
+  auto pushNext = [&](int idx) {
+    string key = keyOf(idx);
+    if (highKey.empty() || key < highKey)
+      min_heap.push({key, idx});
+  };
+  for (int idx = 0; idx < runCount; ++idx) {
+    if (!lowKey.empty()) {
+      // first page whose last row is not below lowKey
+      uint low = 0, high = runs[idx]->blockCount;
+      while (low < high) {
+        uint mid = (low + high) / 2;
+        vector<vector<int>> rows = runs[idx]->readPage(mid);
+        if (sortKey(rows.back(), columnIndices, sortingStrategy) < lowKey)
+          low = mid + 1;
+        else
+          high = mid;
+      }
+      nextPages[idx] = low;
+    }
+    prefetch(idx);
+    if (!advance(idx))
+      continue;
+    while (nextRows[idx] < (int)currentPages[idx].size() - 1 && !lowKey.empty() &&
+           keyOf(idx) < lowKey)
+      ++nextRows[idx];
+    pushNext(idx);
   }
 
-  // create an empty table and put all the data from the min heap
-  // into the pages of this table 
-  string currentTableName = this->tableName + "_" + to_string(round) + "_" + to_string(setCount);
-  cout << "Creating table " << currentTableName << "\n";
-  Table *resultantTable = new Table(currentTableName, this->columns);
-
-  int idx = 0;
+  vector<vector<int>> rowsInPage;
+  vector<int> lastRow;
   while (!min_heap.empty()) {
-    // cout << "Min heap size: " << min_heap.size() << "\n";
-    vector<int> row = min_heap.top().first;
     int idx = min_heap.top().second;
     min_heap.pop();
+    vector<int> &row = currentPages[idx][nextRows[idx]];
+
+    if (!distinct || row != lastRow) {
+      rowsInPage.push_back(row);
+      if (rowsInPage.size() == resultantTable->maxRowsPerBlock) {
+        resultantTable->appendPage(rowsInPage);
+        rowsInPage.clear();
+      }
+      lastRow = row;
+    }
+    // move on to the next row of the run at idx
+    if (++nextRows[idx] < (int)currentPages[idx].size() || advance(idx))
+      pushNext(idx);
+  }
+  if (!rowsInPage.empty())
+    resultantTable->appendPage(rowsInPage);
+  {
+    lock_guard<mutex> lock(requestMutex);
+    merged = true;
+  }
+  requestReady.notify_one();
+  reader.join();
+}
+
+/**
+ * @brief First phase of the external sort. Sorted runs are generated from the
+ * blocks [firstBlock, endBlock) with replacement selection, rows being
+ * compared on their sortKey: a heap holding as many rows as fit in heapBlocks
+ * blocks repeatedly outputs its smallest row to the current run and
+ * takes in the next input row. An incoming row smaller than the row just
+ * output can't extend the current run and is held back for the next one. Runs
+ * are on average twice as long as the memory, and an input that is already
+ * sorted yields a single run. Each run is stored as the table
+ * <runPrefix>_0_<run>, and the key of the first row of every page written is
+ * added to pageKeys.
+ *
+ * Rows that compare equal are output in input order within a run and never
+ * land in an earlier run than a row read before them, so merging the runs in
+ * order keeps the sort stable. If distinct is set, duplicate rows are dropped
+ * from each run; this requires sorting on every column.
+ *
+ * @param sortColumnNames
+ * @param sortingStrategy
+ * @param runPrefix
+ * @param distinct
+ * @param firstBlock
+ * @param endBlock
+ * @param heapBlocks
+ * @param pageKeys
+ * @return vector<Table*> the runs created, in order
+ */
+vector<Table*> Table::generateRuns(vector<string> sortColumnNames, vector<int> sortingStrategy,
+                                   string runPrefix, bool distinct, uint firstBlock,
+                                   uint endBlock, uint heapBlocks, vector<string> &pageKeys) {
+  logger.log("Table::generateRuns");
+  vector<int> columnIndices;
+  for (string &columnName : sortColumnNames)
+    columnIndices.push_back(this->getColumnIndex(columnName));
+
+  // (run, sortKey, input position, row), the heap top being the entry of the
+  // lowest run and then the smallest key, read first
+  typedef tuple<int, string, long long, vector<int>> RunEntry;
+  priority_queue<RunEntry, vector<RunEntry>, greater<RunEntry>> heap;
+  uint heapCapacity = heapBlocks * this->maxRowsPerBlock;
+
+  vector<Table*> runs;
+  vector<vector<int>> rowsInPage;
+  vector<int> lastRow;
+  // moves the top of the heap to its run, returning the row and its run
+  auto output = [&]() {
+    RunEntry entry = heap.top();
+    heap.pop();
+    vector<int> &row = get<3>(entry);
+    if (get<0>(entry) == (int)runs.size()) {
+      if (!runs.empty() && !rowsInPage.empty())
+        runs.back()->appendPage(rowsInPage);
+      rowsInPage.clear();
+      runs.push_back(new Table(runPrefix + "_0_" + to_string(runs.size()), this->columns));
+      tableCatalogue.insertTable(runs.back());
+    } else if (distinct && row == lastRow) {
+      return entry;
+    }
+    if (rowsInPage.empty())
+      pageKeys.push_back(get<1>(entry));
+    rowsInPage.push_back(row);
+    if (rowsInPage.size() == this->maxRowsPerBlock) {
+      runs.back()->appendPage(rowsInPage);
+      rowsInPage.clear();
+    }
+    lastRow = row;
+    return entry;
+  };
+
+  long long position = 0;
+  for (uint idx = firstBlock; idx < endBlock; ++idx) {
+    vector<vector<int>> tableData = this->readPage(idx);
+    for (vector<int> &row : tableData) {
+      string key = sortKey(row, columnIndices, sortingStrategy);
+      if (heap.size() == heapCapacity) {
+        RunEntry previous = output();
+        int nextRun = key < get<1>(previous) ? get<0>(previous) + 1 : get<0>(previous);
+        heap.push(RunEntry(nextRun, key, position++, row));
+      } else {
+        heap.push(RunEntry(0, key, position++, row));
+      }
+    }
+  }
+  while (!heap.empty())
+    output();
+  if (!rowsInPage.empty())
+    runs.back()->appendPage(rowsInPage);
+  logger.log("Table::generateRuns: " + to_string(runs.size()) + " runs from " +
+             to_string(endBlock - firstBlock) + " blocks");
+  return runs;
+}
+
+/**
+ * @brief Second phase of the external sort. The runs are merged K at a time
+ * until at most K are left. Every input run takes two blocks of the pool so
+ * that its next page can be read while the current one is merged, and one
+ * block is kept for the output, so K is (BLOCK_COUNT - 1) / 2 (at least 2).
+ * Up to threadCount merges of a round run at once, each into a table
+ * <runPrefix>_<round>_<set>.
+ *
+ * The last round is split by key range rather than by runs when threadCount is
+ * more than 1: threadCount - 1 splitters are picked from pageKeys, the keys of
+ * the first rows of the run pages, and every thread merges the rows of all
+ * the runs that fall between two splitters into a table of its own. Runs are
+ * deleted as soon as they have been merged, and every round is counted in
+ * mergePassCounter.
+ *
+ * @param sortColumnNames
+ * @param sortingStrategy
+ * @param runPrefix
+ * @param runs
+ * @param distinct drop duplicate rows while merging
+ * @param threadCount
+ * @param pageKeys
+ * @return vector<Table*> non-empty tables that hold the sorted rows in order
+ * when read one after another
+ */
+vector<Table*> Table::mergeRuns(vector<string> sortColumnNames, vector<int> sortingStrategy,
+                                string runPrefix, vector<Table*> runs, bool distinct,
+                                uint threadCount, vector<string> &pageKeys) {
+  logger.log("Table::mergeRuns");
+  uint K = max(2, ((int)BLOCK_COUNT - 1) / 2);
+  int round = 0;
+  bool splitByKey = false;
+  while (runs.size() > 1 && !splitByKey) {
+    ++round;
+    mergePassCounter++;
+    logger.log("Table::mergeRuns: Round " + to_string(round) + " | Runs: " + to_string(runs.size()));
+
+    // the runs and the key range of every merge of this round
+    vector<vector<Table*>> sets;
+    vector<string> splitters(1, "");
+    splitByKey = runs.size() <= K && threadCount > 1;
+    if (splitByKey) {
+      sort(pageKeys.begin(), pageKeys.end());
+      for (uint worker = 1; worker < threadCount; worker++)
+        splitters.push_back(pageKeys[pageKeys.size() * worker / threadCount]);
+      splitters.erase(unique(splitters.begin(), splitters.end()), splitters.end());
+      sets.assign(splitters.size(), runs);
+      splitters.push_back("");
+    } else {
+      for (uint first = 0; first < runs.size(); first += K)
+        sets.emplace_back(runs.begin() + first, runs.begin() + min(first + K, (uint)runs.size()));
+    }
 
-    // for(int &n: row) {
-    //   cout << n << " ";
-    // }
-    // cout << "\n";
-    resultantTable->writeRow(row);
-    // get the next row from the cursor at idx
-    row = blockCursors[idx].getNext();
+    // the tables are created up front as the merges look tables up in the
+    // catalogue
+    vector<Table*> mergedRuns;
+    for (uint set = 0; set < sets.size(); set++) {
+      mergedRuns.push_back(new Table(runPrefix + "_" + to_string(round) + "_" + to_string(set),
+                                     this->columns));
+      tableCatalogue.insertTable(mergedRuns.back());
+    }
+    for (uint first = 0; first < sets.size(); first += threadCount) {
+      vector<thread> workers;
+      for (uint set = first; set < min(first + threadCount, (uint)sets.size()); set++)
+        workers.emplace_back([&, set]() {
+          if (splitByKey)
+            this->merge(sortColumnNames, sortingStrategy, sets[set], mergedRuns[set], distinct,
+                        splitters[set], splitters[set + 1]);
+          else
+            this->merge(sortColumnNames, sortingStrategy, sets[set], mergedRuns[set], distinct,
+                        "", "");
+        });
+      for (thread &worker : workers)
+        worker.join();
+    }
 
-    if(!row.empty()) {
-      min_heap.push({row, idx});
+    for (Table* run : runs) {
+      logger.log("Deleting table: " + run->tableName);
+      tableCatalogue.deleteTable(run->tableName);
+    }
+    runs.clear();
+    for (Table* run : mergedRuns) {
+      if (run->blockCount == 0)
+        tableCatalogue.deleteTable(run->tableName);
+      else
+        runs.push_back(run);
     }
   }
+  return runs;
+}
 
-  resultantTable->blockify();
-  tableCatalogue.insertTable(resultantTable);
+/**
+ * @brief Sorts the rows of this table with external merge sort and returns
+ * the tables holding them, named after runPrefix. When the table is large
+ * enough, runs are generated by several threads at once, one per core, each
+ * working on its own range of blocks, and mergeRuns then merges with as many
+ * threads. The BLOCK_COUNT - 2 blocks of the heap (one block is kept for the
+ * input page and one for the output page) are shared out among the threads,
+ * so there are at most that many. Runs of earlier ranges come first, so the
+ * sort stays stable.
+ *
+ * @param sortColumnNames
+ * @param sortingStrategy
+ * @param runPrefix
+ * @param distinct drop duplicate rows; requires sorting on every column
+ * @return vector<Table*> see mergeRuns
+ */
+vector<Table*> Table::externalSort(vector<string> sortColumnNames, vector<int> sortingStrategy,
+                                   string runPrefix, bool distinct) {
+  logger.log("Table::externalSort");
+  uint threadCount = min({max(thread::hardware_concurrency(), 1u),
+                          max(this->blockCount / (BLOCK_COUNT - 2), 1u), BLOCK_COUNT - 2});
+  uint heapBlocks = (BLOCK_COUNT - 2) / threadCount;
+  vector<vector<Table*>> threadRuns(threadCount);
+  vector<vector<string>> threadKeys(threadCount);
+  vector<thread> workers;
+  for (uint worker = 0; worker < threadCount; worker++)
+    workers.emplace_back([&, worker]() {
+      string prefix = threadCount == 1 ? runPrefix : runPrefix + "_w" + to_string(worker);
+      threadRuns[worker] = this->generateRuns(sortColumnNames, sortingStrategy, prefix, distinct,
+                                              this->blockCount * worker / threadCount,
+                                              this->blockCount * (worker + 1) / threadCount,
+                                              heapBlocks, threadKeys[worker]);
+    });
+  for (thread &worker : workers)
+    worker.join();
+
+  vector<Table*> runs;
+  vector<string> pageKeys;
+  for (uint worker = 0; worker < threadCount; worker++) {
+    runs.insert(runs.end(), threadRuns[worker].begin(), threadRuns[worker].end());
+    pageKeys.insert(pageKeys.end(), threadKeys[worker].begin(), threadKeys[worker].end());
+  }
+  logger.log("Table::externalSort: " + to_string(runs.size()) + " runs with " +
+             to_string(threadCount) + " threads");
+  return this->mergeRuns(sortColumnNames, sortingStrategy, runPrefix, runs, distinct,
+                         threadCount, pageKeys);
 }
 
+/**
+ * @brief Sorts the table in place on sortColumnNames. A table that fits in
+ * BLOCK_COUNT - 2 blocks is radix sorted in memory, otherwise externalSort is
+ * used and the sorted rows are written back over the pages of this table,
+ * which are removed from the pool so that they are read again on next access.
+ * The indexes of the table are then built again on the sorted pages.
+ *
+ * @param sortColumnNames
+ * @param sortingStrategy ASC or DESC for each column of sortColumnNames
+ */
 void Table::sortTable(vector<string> sortColumnNames, vector<int> sortingStrategy) {
   logger.log("Table::sort");
 
-  Cursor cursor = this->getCursor();
-  vector<int> row;
-  // load the values onto tableData
-  vector<vector<int>> tableData;
-  
-  for (int idx = 0; idx < this->blockCount; ++idx) {
-    // // load the values onto tableData
-    // vector<vector<int>> tableData;
-    logger.log(to_string(idx));
-
-    int count = this->rowsPerBlockCount[idx];
-    while (count > 0) {
-        row = cursor.getNext();      
-        tableData.push_back(row);
-      --count;
+  if (this->isSortedOn(sortColumnNames, sortingStrategy))
+    return;
+  this->sortedColumns = sortColumnNames;
+  this->sortedStrategy = sortingStrategy;
+  if (this->blockCount == 0)
+    return;
+  // rows move to other pages, so the indexes are built again once they are in
+  // place; the Bloom filters follow the pages as they are written
+  string indexedColumn = this->indexedColumn;
+  IndexingStrategy indexingStrategy = this->indexingStrategy;
+  vector<string> includedColumns = this->includedColumns;
+  vector<string> bitmapIndexedColumns = this->bitmapIndexedColumns;
+  this->dropIndexes();
+  // the rows no longer follow the source file, for which the indexes of the
+  // catalogue were built
+  if (this->pagesMatchSource)
+    this->removeIndexCatalogue();
+  this->pagesMatchSource = false;
+  if (this->blockCount <= BLOCK_COUNT - 2) { // fits in memory, no runs needed
+    vector<vector<int>> tableData;
+    for (int idx = 0; idx < this->blockCount; ++idx) {
+      vector<vector<int>> pageData = this->readPage(idx);
+      for (vector<int> &row : pageData)
+        tableData.push_back(move(row));
     }
-
-    // sort the tableData 2D vector
-    ::stable_sort(tableData.begin(), tableData.end(), 
-            [this, &sortColumnNames, &sortingStrategy](const vector<int> &A, const vector<int> &B) {
-             // check in the order of the column names
-            
-             for (int idx = 0; idx < (int)sortColumnNames.size(); idx++) {
-               int colIdx = this->getColumnIndex(sortColumnNames[idx]);
-             
-               if (A[colIdx] != B[colIdx]) {
-                //  logger.log("in if");
-                 if (sortingStrategy[idx] == ASC) {
-                   return A[colIdx] < B[colIdx];
-                 } else {
-                   return A[colIdx] > B[colIdx];
-                 }
-               }
-             }
-             
-            return false;
-           });
-
-    logger.log("Table::sort: Writing sorted page back into memory");
-
-
-    if(this->blockCount == 1) {// no merging step needed
+    this->sortRows(tableData, sortColumnNames, sortingStrategy);
+    auto row = tableData.begin();
+    for (int idx = 0; idx < this->blockCount; ++idx) {
+      vector<vector<int>> pageData(row, row + this->rowsPerBlockCount[idx]);
+      row += this->rowsPerBlockCount[idx];
       // overwrite contents of table page
-      bufferManager.writePage(this->tableName, 0, tableData, (int)tableData.size());
-      // remove the page from the cache so that it is loaded again 
-      bufferManager.removeFromPool(this->tableName, 0);
-      return;
+      bufferManager.writePage(this->tableName, idx, pageData, (int)pageData.size());
+      this->updateBloomFilters(idx, pageData, pageData.size());
+      // remove the page from the cache so that it is loaded again
+      bufferManager.removeFromPool(this->tableName, idx);
     }
-    else {
-      // create an empty table and put all the data
-      // into the pages of this table 
-      string currentTableName = this->tableName + "_0_" + to_string(idx);
-      Table *resultantTable = new Table(currentTableName, this->columns);
+  } else {
+    this->externalSortInPlace(sortColumnNames, sortingStrategy);
+  }
 
-      for(vector<int> &row: tableData) {
-        resultantTable->writeRow(row);
-      }
+  if (indexingStrategy != NOTHING)
+    this->buildIndex(indexedColumn, indexingStrategy, includedColumns);
+  for (string &columnName : bitmapIndexedColumns)
+    this->buildIndex(columnName, BITMAP);
+}
 
-      resultantTable->blockify();
-      tableCatalogue.insertTable(resultantTable);
-    }
-    tableData.clear();
-  }
-
-  logger.log("Table::sort: Internal sorting complete");
-  logger.log("Table::sort: Merging pages");
-  // NOTE: we need to merge the internally sorted pages using K-way mergesort
-  // Since we have 10 blocks in total, we will use 9 for reading blocks
-  // and 1 for writing block
-  int rounds = ceil(log(this->blockCount) / log(9));
-  int set_size = 1;
-  int maxRowsPerBlock = this->rowsPerBlockCount[0];
-  int K = 9;
-  
-  logger.log("Table::sort: Rounds: " + to_string(rounds) + " | maxRowsPerBlock: " + to_string(maxRowsPerBlock));
-
-  for (int r = 1; r <= rounds; ++r) {
-    // cout << "Round" << r << ": \n";
-    int sets = ceil((1.0 * this->blockCount) / set_size);
-    // cout << this->blockCount << " | " << set_size << " | Sets: " << sets
-    //      << "\n";
-    int blockCount = 0;
-    int setCount = 0;
-    // get the cursor from each set (upto K cursors at a time)
-    vector<Cursor> blockCursors;
-    for (int s = 0; s < sets; ++s) {
-      string prevTableName = this->tableName + "_" + to_string(r - 1) + "_" + to_string(s);
-      // cout << "Getting cursor for " << prevTableName + "_Page0" << "\n";
-
-      Cursor cursor = Cursor(prevTableName, 0);
-      blockCursors.push_back(cursor);
-
-      if ((int)blockCursors.size() == K) {
-        // cout << "Got K cursors, now start merging\n";
-        logger.log("Got K cursors, now start merging\n");
-
-        this->merge(sortColumnNames, sortingStrategy, blockCursors, r, setCount);
-
-        // cout << "Deleting the previously read tables\n";
-        logger.log("Deleting the previously read tables\n");
-
-        for (int id = s; id > s - (int)blockCursors.size(); --id) {
-          string prevTableName =  this->tableName + "_" + to_string(r - 1) + "_" + to_string(id);
-          // cout << "Deleting table: " << prevTableName << "\n";
-          logger.log("Deleting table block cursor size == k: " + prevTableName + "\n");
-          // tableCatalogue.getTable(prevTableName)->unload();
-          int pageIdx = 0;
-          while(bufferManager.removeFromPool(prevTableName, pageIdx)) {
-            ++pageIdx;
-          }
-          tableCatalogue.deleteTable(prevTableName);
-          bufferManager.deleteFile(prevTableName);
-        }
+/**
+ * @brief Sorts the table with externalSort and writes the sorted rows back
+ * over its pages, which are removed from the pool so that they are read again
+ * on next access.
+ *
+ * @param sortColumnNames
+ * @param sortingStrategy
+ */
+void Table::externalSortInPlace(vector<string> sortColumnNames, vector<int> sortingStrategy) {
+  logger.log("Table::externalSortInPlace");
 
-        ++setCount;
-        // clear the blockCursors vector
-        blockCursors.clear();
-      }
-    }
-    if (!blockCursors.empty()) {
-      // cout << "Merging remaining pages\n";
-      logger.log("Merging remaining pages\n");
-
-      this->merge(sortColumnNames, sortingStrategy, blockCursors, r, setCount);
-      
-      for (int id = sets - 1; id >= sets - (int)blockCursors.size(); --id) {
-        string prevTableName =  this->tableName + "_" + to_string(r - 1) + "_" + to_string(id);
-        // cout << "Deleting table: " << prevTableName << "\n";
-        logger.log("Deleting table block cursor not empty: " + prevTableName + "\n");
-        // tableCatalogue.getTable(prevTableName)->unload();
-        int pageIdx = 0;
-        while(bufferManager.removeFromPool(prevTableName, pageIdx)) {
-          ++pageIdx;
-        }
-        tableCatalogue.deleteTable(prevTableName);
-        bufferManager.deleteFile(prevTableName);
-      }
-      
-      ++setCount;
-      // clear the blockCursors vector
-      blockCursors.clear();
-    }
-    set_size *= K;
-    logger.log("Done\n");
-    // cout << "Done\n";
-  }
-
-  // cout << "Writing the final sorted pages into memory" << endl;
-
-  // TODO: replace the original pages with the pages of the final round
-  // (Maybe rename these pages directly to reduce block access)
-  
-  string currentTableName = this->tableName + "_" + to_string(rounds) + "_0";
-  cursor = tableCatalogue.getTable(currentTableName)->getCursor();
-  // cout << "Creating table " << currentTableName << "\n";
-  //
-  // cout << "Total blocks: " << this->blockCount << endl;
-  
-  // cursor.getNext(); // skip the first row containing header
-  row = cursor.getNext();
+  vector<Table*> sortedRuns = this->externalSort(sortColumnNames, sortingStrategy,
+                                                 this->tableName, false);
+
+  // replace the original pages with the rows of the sorted runs, in order
+  uint runCounter = 0;
+  Cursor cursor = sortedRuns[0]->getCursor();
+  vector<int> row = cursor.getNext();
   for (int idx = 0; idx < this->blockCount; ++idx) {
-    // Cursor cursor = bufferManager.getPage(currentTableName, idx);
-    
-    // cout << "Block: " << idx << endl;
-    // cout << "Row Count: " <<  this->rowsPerBlockCount[idx] << "\n";
-    // load the values onto tableData
     vector<vector<int>> tableData;
     int count = this->rowsPerBlockCount[idx];
-    while (count > 0) {
-      if(!row.empty()) {
-        tableData.push_back(row);
+    while (count > 0 && !row.empty()) {
+      tableData.push_back(row);
+      row = cursor.getNext();
+      if (row.empty() && ++runCounter < sortedRuns.size()) {
+        cursor = sortedRuns[runCounter]->getCursor();
         row = cursor.getNext();
       }
-      else{
-        cout << "Empty row\n";
-        break;
-      }
       --count;
     }
 
-    // cout << "Table Size: " << tableData.size() << endl;
-    // overwrite the contents of the current table pages 
+    // overwrite the contents of the current table pages
     bufferManager.writePage(this->tableName, idx, tableData, (int)tableData.size());
+    this->updateBloomFilters(idx, tableData, tableData.size());
 
-    // remove the page from the cache so that it is loaded again 
+    // remove the page from the cache so that it is loaded again
     bufferManager.removeFromPool(this->tableName, idx);
-    // cout << idx << "Done" << endl;
   }
 
   logger.log("Table::sort: External sorting complete");
-  
-  int pageIdx = 0;
-  while(bufferManager.removeFromPool(currentTableName, pageIdx)) {
-    ++pageIdx;
+  for (Table* run : sortedRuns)
+    tableCatalogue.deleteTable(run->tableName);
+}
+
+/**
+ * @brief Checks if the rows are known to be in order of columnNames, each in
+ * its sortingStrategy, i.e. if these lead the order the table was left in.
+ *
+ * @param columnNames
+ * @param sortingStrategy
+ * @return true if no sort is needed to get this order
+ */
+bool Table::isSortedOn(vector<string> columnNames, vector<int> sortingStrategy) {
+  logger.log("Table::isSortedOn");
+  if (columnNames.empty() || columnNames.size() > this->sortedColumns.size())
+    return false;
+  for (int columnCounter = 0; columnCounter < columnNames.size(); columnCounter++)
+    if (columnNames[columnCounter] != this->sortedColumns[columnCounter] ||
+        sortingStrategy[columnCounter] != this->sortedStrategy[columnCounter])
+      return false;
+  return true;
+}
+
+/**
+ * @brief Takes the order of table, whose rows this table holds in the same
+ * order, as far as its leading columns are columns of this table.
+ *
+ * @param table
+ */
+void Table::inheritSortOrder(Table* table) {
+  logger.log("Table::inheritSortOrder");
+  this->sortedColumns.clear();
+  this->sortedStrategy.clear();
+  for (int columnCounter = 0; columnCounter < table->sortedColumns.size(); columnCounter++) {
+    if (!this->isColumn(table->sortedColumns[columnCounter]))
+      break;
+    this->sortedColumns.push_back(table->sortedColumns[columnCounter]);
+    this->sortedStrategy.push_back(table->sortedStrategy[columnCounter]);
   }
-  tableCatalogue.deleteTable(currentTableName);
-  bufferManager.deleteFile(currentTableName);
 }
 
-void Table::join(Table* table1, Table* table2, string col1, string col2, int binaryop){
-  logger.log("Table::join");
+/**
+ * @brief Block nested-loop join of table1 and table2. The outer relation is
+ * read in chunks of (BLOCK_COUNT - 2) blocks, one block being kept for the
+ * page of the inner relation and one for the output, and the inner relation
+ * is scanned once per chunk rather than once per outer row. The relation
+ * that needs fewer block reads as the outer side is chosen as the outer
+ * relation. Resultant rows are always the row of table1 followed by the row
+ * of table2.
+ *
+ * Used for the cross product (binaryop is NO_BINOP_CLAUSE and the column
+ * indices are ignored) and for joins that can't use sorting or hashing, i.e.
+ * !=.
+ *
+ * @param table1
+ * @param table2
+ * @param index1 index of the join column of table1
+ * @param index2 index of the join column of table2
+ * @param binaryop join condition, NO_BINOP_CLAUSE for the cross product
+ */
+void Table::blockNestedLoopJoin(Table* table1, Table* table2, int index1, int index2, int binaryop){
+  logger.log("Table::blockNestedLoopJoin");
 
-  map<int, BinaryOperator> mp = 
-  {
-    {0, LESS_THAN},
-    {1, GREATER_THAN},
-    {2, LEQ},
-    {3, GEQ},
-    {4, EQUAL},
-    {5, NOT_EQUAL},
-    {6, NO_BINOP_CLAUSE}
+  BinaryOperator binaryOperator = (BinaryOperator)binaryop;
+  uint frames = BLOCK_COUNT - 2;
+  auto cost = [frames](uint outerBlocks, uint innerBlocks) {
+    return outerBlocks + (outerBlocks + frames - 1) / frames * innerBlocks;
   };
-
+  bool outerIsFirst = cost(table1->blockCount, table2->blockCount) <=
+                      cost(table2->blockCount, table1->blockCount);
+  Table* outerTable = outerIsFirst ? table1 : table2;
+  Table* innerTable = outerIsFirst ? table2 : table1;
+  int outerIndex = outerIsFirst ? index1 : index2;
+  int innerIndex = outerIsFirst ? index2 : index1;
+
+  ofstream fout(this->sourceFileName, ios::app);
   vector<int> resultantRow;
   resultantRow.reserve(this->columnCount);
+  for (uint chunkStart = 0; chunkStart < outerTable->blockCount; chunkStart += frames) {
+    vector<vector<int>> chunk;
+    for (uint pageCounter = chunkStart;
+         pageCounter < min(chunkStart + frames, outerTable->blockCount); pageCounter++) {
+      vector<vector<int>> rows = outerTable->readPage(pageCounter);
+      chunk.insert(chunk.end(), rows.begin(), rows.end());
+    }
+
+    for (int pageCounter = 0; pageCounter < innerTable->blockCount; pageCounter++) {
+      vector<vector<int>> innerRows = innerTable->readPage(pageCounter);
+      for (vector<int> &outerRow : chunk) {
+        for (vector<int> &innerRow : innerRows) {
+          if (binaryOperator != NO_BINOP_CLAUSE &&
+              !evaluateBinOp(outerRow[outerIndex], innerRow[innerIndex], binaryOperator))
+            continue;
+          vector<int> &firstRow = outerIsFirst ? outerRow : innerRow;
+          vector<int> &secondRow = outerIsFirst ? innerRow : outerRow;
+          resultantRow.assign(firstRow.begin(), firstRow.end());
+          resultantRow.insert(resultantRow.end(), secondRow.begin(), secondRow.end());
+          this->writeRow<int>(resultantRow, fout);
+        }
+      }
+    }
+  }
+  fout.close();
+
+  this->blockify();
+}
+
+/**
+ * @brief Sort-merge equi-join of table1 and table2 on col1 == col2. Both tables
+ * must already be sorted in ascending order of their join column. The two
+ * tables are read once, in step. When the keys match, all rows of table2 with
+ * that key are buffered and paired with every row of table1 with the same key,
+ * so duplicate keys on either side produce every matching pair.
+ *
+ * @param table1
+ * @param table2
+ * @param col1 join column of table1
+ * @param col2 join column of table2
+ */
+void Table::mergeJoin(Table* table1, Table* table2, string col1, string col2){
+  logger.log("Table::mergeJoin");
 
   Cursor cursor1 = table1->getCursor();
   Cursor cursor2 = table2->getCursor();
-
   vector<int> row1 = cursor1.getNext();
   vector<int> row2 = cursor2.getNext();
-
   int ind1 = table1->getColumnIndex(col1);
   int ind2 = table2->getColumnIndex(col2);
 
-  // EQUAL
-  if(binaryop == 4){
-    logger.log("Equal join");
-    while (!row1.empty() && !row2.empty() ){
-      if(evaluateBinOp(row1[ind1], row2[ind2], GREATER_THAN))
-      {
-        row2 = cursor2.getNext();
-      }
-      else if(evaluateBinOp(row1[ind1], row2[ind2], mp[binaryop]))
-      {
-        resultantRow = row1;
-        resultantRow.insert(resultantRow.end(), row2.begin(), row2.end());
+  ofstream fout(this->sourceFileName, ios::app);
+  vector<int> resultantRow;
+  resultantRow.reserve(this->columnCount);
+  vector<vector<int>> group;
 
-        this->writeRow<int>(resultantRow);
-        row2 = cursor2.getNext();
-      }
-      else
-      {
-        row1 = cursor1.getNext();
-      }
-    }
-  }
-  // LESS THAN
-  else if(binaryop == 0){
-    logger.log("Less than join");
-     
-     while (!row1.empty() && !row2.empty() ){
-      if(evaluateBinOp(row1[ind1], row2[ind2], GEQ))
-        {
-          row2 = cursor2.getNext();
-        }
-        else 
-        {
-          Cursor cursor3 = cursor2;
-          vector<int> row3 = row2;
-
-          while(!row3.empty())
-          {
-            resultantRow = row1;
-            resultantRow.insert(resultantRow.end(), row3.begin(), row3.end());
-
-            logger.log("Printing res row:");
-            string temp = "";
-            for(int i=0; i<resultantRow.size(); i++)
-              temp += to_string(resultantRow[i]);
-            logger.log(temp);
-
-            this->writeRow<int>(resultantRow);
-            row3 = cursor3.getNext();
-          }
-          row1 = cursor1.getNext();
-        }
+  while (!row1.empty() && !row2.empty()) {
+    if (row1[ind1] < row2[ind2]) {
+      row1 = cursor1.getNext();
+      continue;
     }
-  }
-  // LESS THAN EQUAL TO
-  else if(binaryop == 2){
-    logger.log("Less than equal join");
-     
-     while (!row1.empty() && !row2.empty() ){
-      if(evaluateBinOp(row1[ind1], row2[ind2], GREATER_THAN))
-        {
-          row2 = cursor2.getNext();
-        }
-        else 
-        {
-          Cursor cursor3 = cursor2;
-          vector<int> row3 = row2;
-
-          while(!row3.empty())
-          {
-            resultantRow = row1;
-            resultantRow.insert(resultantRow.end(), row3.begin(), row3.end());
-
-            logger.log("Printing res row:");
-            string temp = "";
-            for(int i=0; i<resultantRow.size(); i++)
-              temp += to_string(resultantRow[i]);
-            logger.log(temp);
-
-            this->writeRow<int>(resultantRow);
-            row3 = cursor3.getNext();
-          }
-          row1 = cursor1.getNext();
-        }
+    if (row1[ind1] > row2[ind2]) {
+      row2 = cursor2.getNext();
+      continue;
     }
-  }
-  // GREATER THAN 
-  else if(binaryop == 1){
-    logger.log("Greater than join");
-     
-     while (!row1.empty() && !row2.empty() ){
-      if(evaluateBinOp(row1[ind1], row2[ind2], LEQ))
-        {
-          row2 = cursor2.getNext();
-        }
-        else 
-        {
-          Cursor cursor3 = cursor2;
-          vector<int> row3 = row2;
-
-          while(!row3.empty())
-          {
-            resultantRow = row1;
-            resultantRow.insert(resultantRow.end(), row3.begin(), row3.end());
-
-            logger.log("Printing res row:");
-            string temp = "";
-            for(int i=0; i<resultantRow.size(); i++)
-              temp += to_string(resultantRow[i]);
-            logger.log(temp);
-
-            this->writeRow<int>(resultantRow);
-            row3 = cursor3.getNext();
-          }
-          row1 = cursor1.getNext();
-        }
-    }  
-  }
-  // GREATER THAN EQUAL TO
-  else if(binaryop == 3){
-    logger.log("Greater than equal join");
-     
-     while (!row1.empty() && !row2.empty() ){
-      if(evaluateBinOp(row1[ind1], row2[ind2], LESS_THAN))
-        {
-          row2 = cursor2.getNext();
-        }
-        else 
-        {
-          Cursor cursor3 = cursor2;
-          vector<int> row3 = row2;
-
-          while(!row3.empty())
-          {
-            resultantRow = row1;
-            resultantRow.insert(resultantRow.end(), row3.begin(), row3.end());
-
-            logger.log("Printing res row:");
-            string temp = "";
-            for(int i=0; i<resultantRow.size(); i++)
-              temp += to_string(resultantRow[i]);
-            logger.log(temp);
-
-            this->writeRow<int>(resultantRow);
-            row3 = cursor3.getNext();
-          }
-          row1 = cursor1.getNext();
-        }
+
+    int key = row2[ind2];
+    group.clear();
+    while (!row2.empty() && row2[ind2] == key) {
+      group.push_back(row2);
+      row2 = cursor2.getNext();
     }
-  }
-  // NOT EQUAL
-  else if(binaryop == 5){
-    logger.log("Not equal join");
-     
-      while (!row1.empty())
-      {
-        cursor2 = table2->getCursor();
-        row2 = cursor2.getNext();
-        while (!row2.empty())
-        { 
-            if(evaluateBinOp(row1[ind1], row2[ind2], NOT_EQUAL)){
-              resultantRow = row1;
-              resultantRow.insert(resultantRow.end(), row2.begin(), row2.end());
-              this->writeRow<int>(resultantRow);
-            }
-            row2 = cursor2.getNext();
-        }
-        row1 = cursor1.getNext();
+    while (!row1.empty() && row1[ind1] == key) {
+      for (vector<int> &groupRow : group) {
+        resultantRow = row1;
+        resultantRow.insert(resultantRow.end(), groupRow.begin(), groupRow.end());
+        this->writeRow<int>(resultantRow, fout);
       }
+      row1 = cursor1.getNext();
+    }
   }
+  fout.close();
 
   this->blockify();
-
 }
 
 /**
- * @brief Copy contents from original table to new table
+ * @brief Band join of table1 and table2 on col1 binaryOperator col2 where the
+ * operator is one of <, <=, > and >=. Both tables must already be sorted in
+ * ascending order of their join column, so the rows of table2 matching any row
+ * of table1 form a contiguous range of table2: a suffix for < and <=, a prefix
+ * for > and >=.
  *
+ * table1 is read in chunks of (BLOCK_COUNT - 2) blocks, one block being kept
+ * for the page of table2 and one for the output, and table2 is scanned once
+ * per chunk. Within a page of table2, each row of the chunk matches a slice of
+ * the page whose boundary only moves one way as the chunk is walked in order,
+ * so the slice is located with a single pointer per page and emitted as a
+ * whole. Pages of table2 that can't match the chunk are skipped: leading pages
+ * below every key of a suffix join are never read again, and a prefix join
+ * stops at the first page above every key of the chunk.
+ *
+ * @param table1
+ * @param table2
+ * @param col1 join column of table1
+ * @param col2 join column of table2
+ * @param binaryop LESS_THAN, LEQ, GREATER_THAN or GEQ
  */
-void Table::copy(Table* table){
-  logger.log("Table::copy");
+void Table::bandJoin(Table* table1, Table* table2, string col1, string col2, int binaryop){
+  logger.log("Table::bandJoin");
 
-  Cursor cursor = table->getCursor();
-  vector<int> row = cursor.getNext();
+  BinaryOperator binaryOperator = (BinaryOperator)binaryop;
+  int ind1 = table1->getColumnIndex(col1);
+  int ind2 = table2->getColumnIndex(col2);
+  bool suffix = binaryOperator == LESS_THAN || binaryOperator == LEQ;
+  auto matches = [binaryOperator](int value1, int value2) {
+    switch (binaryOperator) {
+    case LESS_THAN:
+      return value1 < value2;
+    case LEQ:
+      return value1 <= value2;
+    case GREATER_THAN:
+      return value1 > value2;
+    default:
+      return value1 >= value2;
+    }
+  };
 
-  while(!row.empty()){
-    this->writeRow<int>(row);
-    row = cursor.getNext();
+  ofstream fout(this->sourceFileName, ios::app);
+  vector<int> resultantRow;
+  resultantRow.reserve(this->columnCount);
+  auto emitRange = [&](vector<int> &row1, vector<vector<int>> &rows2, int begin, int end) {
+    for (int rowCounter = begin; rowCounter < end; rowCounter++) {
+      resultantRow.assign(row1.begin(), row1.end());
+      resultantRow.insert(resultantRow.end(), rows2[rowCounter].begin(), rows2[rowCounter].end());
+      this->writeRow<int>(resultantRow, fout);
+    }
+  };
+
+  uint frames = BLOCK_COUNT - 2;
+  int firstPage = 0;
+  for (uint chunkStart = 0; chunkStart < table1->blockCount; chunkStart += frames) {
+    vector<vector<int>> chunk;
+    for (uint pageCounter = chunkStart;
+         pageCounter < min(chunkStart + frames, table1->blockCount); pageCounter++) {
+      vector<vector<int>> rows = table1->readPage(pageCounter);
+      chunk.insert(chunk.end(), rows.begin(), rows.end());
+    }
+    if (chunk.empty())
+      continue;
+
+    for (int pageCounter = suffix ? firstPage : 0; pageCounter < table2->blockCount; pageCounter++) {
+      vector<vector<int>> rows2 = table2->readPage(pageCounter);
+      int rowCount2 = rows2.size();
+      if (suffix) {
+        // the smallest key of the chunk has the longest suffix
+        if (!matches(chunk.front()[ind1], rows2.back()[ind2])) {
+          firstPage = pageCounter + 1;
+          continue;
+        }
+        int begin = 0;
+        for (vector<int> &row1 : chunk) {
+          while (begin < rowCount2 && !matches(row1[ind1], rows2[begin][ind2]))
+            begin++;
+          if (begin == rowCount2)
+            break;
+          emitRange(row1, rows2, begin, rowCount2);
+        }
+      } else {
+        // the largest key of the chunk has the longest prefix
+        if (!matches(chunk.back()[ind1], rows2.front()[ind2]))
+          break;
+        int end = 0;
+        for (vector<int> &row1 : chunk) {
+          while (end < rowCount2 && matches(row1[ind1], rows2[end][ind2]))
+            end++;
+          emitRange(row1, rows2, 0, end);
+        }
+      }
+    }
   }
+  fout.close();
 
   this->blockify();
-
-  // delete csv file
-  string filename = "../data/temp/" + this->tableName + ".csv";
-  logger.log("csv file to be deleted: " + filename);
-  if(remove(filename.c_str()) == 0)
-    logger.log("csv file deleted successfully");
-  else
-    logger.log("csv file deleteion unsuccessful");
 }
 
 /**
- * @brief Trim the table such that it contains only the required columns
+ * @brief Equi-join of table1 and table2 on col1 == col2 using hashing. Neither
+ * input needs to be sorted. Resultant rows are always the row of table1
+ * followed by the row of table2.
  *
+ * @param table1
+ * @param table2
+ * @param col1 join column of table1
+ * @param col2 join column of table2
  */
-void Table::trim(Table* table){
-  logger.log("Table::trim");
-
-  vector<string> cols = this->columns;
-  vector<int> indices;
-  for(int i=0; i<cols.size(); i++)
-    indices.push_back(table->getColumnIndex(cols[i]));
-
-  Cursor cursor = table->getCursor();
-  vector<int> row = cursor.getNext();
-
-  while(!row.empty()){
-      vector<int> resultantRow;
-      resultantRow.reserve(this->columnCount);
-
-      for(int i=0; i<indices.size(); i++)
-        resultantRow.push_back(row[indices[i]]);
+void Table::hashJoin(Table* table1, Table* table2, string col1, string col2){
+  logger.log("Table::hashJoin");
 
-      this->writeRow<int>(resultantRow);
-      row = cursor.getNext();
-  }
+  ofstream fout(this->sourceFileName, ios::app);
+  this->hashJoinPartitions(table1, table2, table1->getColumnIndex(col1),
+                           table2->getColumnIndex(col2), 0, fout);
+  fout.close();
 
   this->blockify();
 }
 
-void Table::calculate(Table* table){
-  logger.log("Table::calculate");
-
-  Cursor cursor = table->getCursor();
-  vector<int> row = cursor.getNext();
-
-  while(!row.empty()){
-      int curr = row[0];
-      int count = 1;
-      int mini = row[1];
-      int maxi = row[1];
-      int sum = row[1];
+/**
+ * @brief Equi-join of table1 and table2 on col1 == col2 through the index of
+ * one of them on its join column, the other one being streamed. Neither input
+ * is sorted or hashed.
+ *
+ * The streamed relation is read (BLOCK_COUNT - 2) blocks at a time. The
+ * distinct keys of a batch are sorted and looked up in the index together, so
+ * its pages are visited in key order, and the locations found are sorted on
+ * page and slot so that every page of the indexed relation is fetched at most
+ * once per batch. Resultant rows are always the row of table1 followed by the
+ * row of table2.
+ *
+ * @param table1
+ * @param table2
+ * @param col1 join column of table1
+ * @param col2 join column of table2
+ * @param probeSecond true if the index of table2 is probed, false for table1
+ */
+void Table::indexNestedLoopJoin(Table* table1, Table* table2, string col1, string col2,
+                                bool probeSecond){
+  logger.log("Table::indexNestedLoopJoin");
 
-      row = cursor.getNext();
+  Table* outerTable = probeSecond ? table1 : table2;
+  Table* innerTable = probeSecond ? table2 : table1;
+  int outerIndex = outerTable->getColumnIndex(probeSecond ? col1 : col2);
 
-      while(!row.empty() && curr == row[0]){
-        count++;
-        mini = min(mini, row[1]);
-        maxi = max(maxi, row[1]);
-        sum += row[1];
+  ofstream fout(this->sourceFileName, ios::app);
+  vector<int> resultantRow;
+  resultantRow.reserve(this->columnCount);
+  uint frames = BLOCK_COUNT - 2;
+  for (uint chunkStart = 0; chunkStart < outerTable->blockCount; chunkStart += frames) {
+    vector<vector<int>> outerRows;
+    for (uint pageCounter = chunkStart;
+         pageCounter < min(chunkStart + frames, outerTable->blockCount); pageCounter++) {
+      vector<vector<int>> rows = outerTable->readPage(pageCounter);
+      outerRows.insert(outerRows.end(), rows.begin(), rows.end());
+    }
 
-        row = cursor.getNext();
+    vector<int> keys;
+    for (vector<int> &row : outerRows)
+      keys.push_back(row[outerIndex]);
+    sort(keys.begin(), keys.end());
+    keys.erase(unique(keys.begin(), keys.end()), keys.end());
+    vector<vector<pair<int, int>>> keyLocations = innerTable->indexLookup(keys);
+
+    // {page, slot, outer row} of every pair of joining rows
+    vector<tuple<int, int, int>> matches;
+    for (int rowCounter = 0; rowCounter < outerRows.size(); rowCounter++) {
+      int key = lower_bound(keys.begin(), keys.end(), outerRows[rowCounter][outerIndex]) -
+                keys.begin();
+      for (pair<int, int> &location : keyLocations[key])
+        matches.emplace_back(location.first, location.second, rowCounter);
+    }
+    sort(matches.begin(), matches.end());
+
+    int pageIndex = -1;
+    vector<vector<int>> innerRows;
+    for (tuple<int, int, int> &match : matches) {
+      if (get<0>(match) != pageIndex) {
+        pageIndex = get<0>(match);
+        innerRows = innerTable->readPage(pageIndex);
       }
-
-      vector<int> resultantRow = {curr, maxi, mini, sum, count};
-      this->writeRow<int>(resultantRow);
+      vector<int> &innerRow = innerRows[get<1>(match)];
+      vector<int> &outerRow = outerRows[get<2>(match)];
+      resultantRow = probeSecond ? outerRow : innerRow;
+      vector<int> &secondRow = probeSecond ? innerRow : outerRow;
+      resultantRow.insert(resultantRow.end(), secondRow.begin(), secondRow.end());
+      this->writeRow<int>(resultantRow, fout);
+    }
   }
+  fout.close();
 
   this->blockify();
 }
 
-void Table::groupBy(Table* table, string aggFunc1, string aggFunc2, int binaryOp, int attrValue){
-  logger.log("Table::groupBy"); 
-
-  map<int, BinaryOperator> mp = 
-  {
-    {0, LESS_THAN},
-    {1, GREATER_THAN},
-    {2, LEQ},
-    {3, GEQ},
-    {4, EQUAL},
-    {5, NOT_EQUAL},
-    {6, NO_BINOP_CLAUSE}
+/**
+ * @brief Hash joins table1 and table2 within the buffer budget and writes the
+ * resultant rows to fout. The relation with fewer blocks is the build side.
+ *
+ * If the build side fits in (BLOCK_COUNT - 2) blocks (one block is kept for the
+ * input page and one for the output) it is read once, indexed in a HashTable
+ * and the other relation is streamed against it.
+ *
+ * Otherwise a hybrid hash join is done. The build side is split into
+ * (BLOCK_COUNT - 2) partitions by hash of the join key. Partitions stay in
+ * memory for as long as they fit; when they don't, the largest resident one
+ * is spilled to a temporary table and keeps a single output block from then
+ * on. The probe side is split with the same hash: rows of resident partitions
+ * are joined right away, rows of spilled partitions are written to temporary
+ * tables. Every pair of spilled partitions is then joined recursively with a
+ * new hash seed.
+ *
+ * Partitioning cannot split a key that by itself does not fit in memory, so
+ * after MAX_PARTITION_DEPTH levels the build side is instead processed in
+ * chunks of (BLOCK_COUNT - 2) blocks, each probed by a full scan of the other
+ * side.
+ *
+ * @param table1
+ * @param table2
+ * @param index1 index of the join column of table1
+ * @param index2 index of the join column of table2
+ * @param depth level of recursive partitioning, 0 for the base relations
+ * @param fout stream resultant rows are written to
+ */
+void Table::hashJoinPartitions(Table* table1, Table* table2, int index1, int index2,
+                               int depth, ostream &fout){
+  logger.log("Table::hashJoinPartitions");
+  const int MAX_PARTITION_DEPTH = 3;
+
+  bool buildIsFirst = table1->blockCount <= table2->blockCount;
+  Table* buildTable = buildIsFirst ? table1 : table2;
+  Table* probeTable = buildIsFirst ? table2 : table1;
+  int buildIndex = buildIsFirst ? index1 : index2;
+  int probeIndex = buildIsFirst ? index2 : index1;
+  uint frames = BLOCK_COUNT - 2;
+
+  vector<int> resultantRow;
+  resultantRow.reserve(this->columnCount);
+  auto emit = [&](vector<int> &buildRow, vector<int> &probeRow) {
+    vector<int> &firstRow = buildIsFirst ? buildRow : probeRow;
+    vector<int> &secondRow = buildIsFirst ? probeRow : buildRow;
+    resultantRow = firstRow;
+    resultantRow.insert(resultantRow.end(), secondRow.begin(), secondRow.end());
+    this->writeRow<int>(resultantRow, fout);
   };
 
+  if (buildTable->blockCount <= frames || depth == MAX_PARTITION_DEPTH) {
+    for (uint chunkStart = 0; chunkStart < buildTable->blockCount; chunkStart += frames) {
+      // load a chunk of the build relation and index it on the join column
+      vector<vector<int>> buildRows;
+      for (uint pageCounter = chunkStart;
+           pageCounter < min(chunkStart + frames, buildTable->blockCount); pageCounter++) {
+        vector<vector<int>> rows = buildTable->readPage(pageCounter);
+        buildRows.insert(buildRows.end(), rows.begin(), rows.end());
+      }
+      HashTable hashTable(buildRows.size());
+      for (int entry = (int)buildRows.size() - 1; entry >= 0; entry--)
+        hashTable.insert(buildRows[entry][buildIndex], entry);
+
+      // the keys of the chunk, when the probe pages have Bloom filters on the
+      // join column, skip the pages whose filter rules them all out
+      int filterIndex = probeTable->bloomFilterIndex(probeTable->columns[probeIndex]);
+      vector<int> buildKeys;
+      if (filterIndex != -1) {
+        for (vector<int> &buildRow : buildRows)
+          buildKeys.push_back(buildRow[buildIndex]);
+        sort(buildKeys.begin(), buildKeys.end());
+        buildKeys.erase(unique(buildKeys.begin(), buildKeys.end()), buildKeys.end());
+      }
+
+      // stream the probe relation
+      for (int pageCounter = 0; pageCounter < probeTable->blockCount; pageCounter++) {
+        if (filterIndex != -1 &&
+            none_of(buildKeys.begin(), buildKeys.end(), [&](int key) {
+              return probeTable->bloomFilters[filterIndex][pageCounter].mayContain(key);
+            }))
+          continue;
+        vector<vector<int>> probeRows = probeTable->readPage(pageCounter);
+        for (vector<int> &probeRow : probeRows)
+          for (int entry = hashTable.find(probeRow[probeIndex]); entry != -1;
+               entry = hashTable.next(entry))
+            emit(buildRows[entry], probeRow);
+      }
+    }
+    return;
+  }
+
+  logger.log("Table::hashJoinPartitions: Partitioning at depth " + to_string(depth));
+  uint partitionCount = frames;
+  string partitionPrefix = this->tableName + "_hj" + to_string(depth) + "_";
+  vector<vector<vector<int>>> partitionRows(partitionCount);
+  vector<Table*> buildPartitions(partitionCount, NULL);
+  vector<Table*> probePartitions(partitionCount, NULL);
+  uint residentPages = 0;
+  uint spilledCount = 0;
+
+  auto pagesOf = [](uint rows, uint rowsPerPage) {
+    return (rows + rowsPerPage - 1) / rowsPerPage;
+  };
+  // moves the full pages of a partition buffer to its temporary table,
+  // leaving the last partially filled page in memory
+  auto flushFullPages = [](Table* partition, vector<vector<int>> &rows) {
+    uint fullRows = rows.size() - rows.size() % partition->maxRowsPerBlock;
+    for (uint rowCounter = 0; rowCounter < fullRows; rowCounter += partition->maxRowsPerBlock) {
+      vector<vector<int>> page(rows.begin() + rowCounter,
+                               rows.begin() + rowCounter + partition->maxRowsPerBlock);
+      partition->appendPage(page);
+    }
+    rows.erase(rows.begin(), rows.begin() + fullRows);
+  };
+  auto newPartition = [&](string side, int partition, vector<string> &columns) {
+    Table* table = new Table(partitionPrefix + side + to_string(partition), columns);
+    tableCatalogue.insertTable(table);
+    return table;
+  };
+
+  // partition the build relation, spilling the largest resident partition
+  // whenever resident pages and spill buffers exceed the budget
+  for (int pageCounter = 0; pageCounter < buildTable->blockCount; pageCounter++) {
+    vector<vector<int>> rows = buildTable->readPage(pageCounter);
+    for (vector<int> &row : rows) {
+      uint partition = HashTable::partitionOf(row[buildIndex], depth, partitionCount);
+      vector<vector<int>> &buffer = partitionRows[partition];
+      buffer.push_back(row);
+      if (buildPartitions[partition]) {
+        if (buffer.size() == buildTable->maxRowsPerBlock)
+          flushFullPages(buildPartitions[partition], buffer);
+        continue;
+      }
+      if ((buffer.size() - 1) % buildTable->maxRowsPerBlock == 0)
+        residentPages++;
+      while (residentPages + spilledCount > frames) {
+        uint victim = partitionCount;
+        for (uint candidate = 0; candidate < partitionCount; candidate++)
+          if (!buildPartitions[candidate] &&
+              (victim == partitionCount ||
+               partitionRows[candidate].size() > partitionRows[victim].size()))
+            victim = candidate;
+        residentPages -= pagesOf(partitionRows[victim].size(), buildTable->maxRowsPerBlock);
+        spilledCount++;
+        buildPartitions[victim] = newPartition("b", victim, buildTable->columns);
+        flushFullPages(buildPartitions[victim], partitionRows[victim]);
+      }
+    }
+  }
+  for (uint partition = 0; partition < partitionCount; partition++)
+    if (buildPartitions[partition] && !partitionRows[partition].empty()) {
+      buildPartitions[partition]->appendPage(partitionRows[partition]);
+      partitionRows[partition].clear();
+    }
+  logger.log("Table::hashJoinPartitions: Spilled " + to_string(spilledCount) +
+             " of " + to_string(partitionCount) + " partitions");
+
+  // index the partitions that stayed in memory
+  vector<vector<int>> residentRows;
+  for (uint partition = 0; partition < partitionCount; partition++) {
+    residentRows.insert(residentRows.end(), partitionRows[partition].begin(),
+                        partitionRows[partition].end());
+    partitionRows[partition].clear();
+  }
+  HashTable hashTable(residentRows.size());
+  for (int entry = (int)residentRows.size() - 1; entry >= 0; entry--)
+    hashTable.insert(residentRows[entry][buildIndex], entry);
+
+  // partition the probe relation, joining rows of resident partitions on
+  // the fly
+  for (int pageCounter = 0; pageCounter < probeTable->blockCount; pageCounter++) {
+    vector<vector<int>> rows = probeTable->readPage(pageCounter);
+    for (vector<int> &row : rows) {
+      uint partition = HashTable::partitionOf(row[probeIndex], depth, partitionCount);
+      if (!buildPartitions[partition]) {
+        for (int entry = hashTable.find(row[probeIndex]); entry != -1;
+             entry = hashTable.next(entry))
+          emit(residentRows[entry], row);
+        continue;
+      }
+      vector<vector<int>> &buffer = partitionRows[partition];
+      buffer.push_back(row);
+      if (buffer.size() == probeTable->maxRowsPerBlock) {
+        if (!probePartitions[partition])
+          probePartitions[partition] = newPartition("p", partition, probeTable->columns);
+        flushFullPages(probePartitions[partition], buffer);
+      }
+    }
+  }
+  residentRows.clear();
+
+  // join every pair of spilled partitions
+  for (uint partition = 0; partition < partitionCount; partition++) {
+    if (!buildPartitions[partition])
+      continue;
+    if (!partitionRows[partition].empty()) {
+      if (!probePartitions[partition])
+        probePartitions[partition] = newPartition("p", partition, probeTable->columns);
+      probePartitions[partition]->appendPage(partitionRows[partition]);
+      partitionRows[partition].clear();
+    }
+    if (probePartitions[partition]) {
+      if (buildIsFirst)
+        this->hashJoinPartitions(buildPartitions[partition], probePartitions[partition],
+                                 index1, index2, depth + 1, fout);
+      else
+        this->hashJoinPartitions(probePartitions[partition], buildPartitions[partition],
+                                 index1, index2, depth + 1, fout);
+      tableCatalogue.deleteTable(probePartitions[partition]->tableName);
+    }
+    tableCatalogue.deleteTable(buildPartitions[partition]->tableName);
+  }
+}
+
+/**
+ * @brief Appends rows as a new page at the end of the table. Used for
+ * temporary tables whose pages are produced directly by an operator instead of
+ * being blockified from a csv file. rows should not be empty and should not
+ * exceed maxRowsPerBlock.
+ *
+ * @param rows
+ */
+void Table::appendPage(vector<vector<int>> &rows) {
+  logger.log("Table::appendPage");
+  bufferManager.writePage(this->tableName, this->blockCount, rows, rows.size());
+  this->updateBloomFilters(this->blockCount, rows, rows.size());
+  this->blockCount++;
+  this->rowsPerBlockCount.emplace_back(rows.size());
+  this->rowCount += rows.size();
+}
+
+/**
+ * @brief Fills this table with the distinct rows of table using a hash set of
+ * the rows seen so far. The input is read once and rows are output in the
+ * order they first appear. The distinct rows have to fit in memory.
+ *
+ * @param table
+ */
+void Table::hashDistinct(Table* table){
+  logger.log("Table::hashDistinct");
+
+  vector<vector<int>> distinctRows;
+  HashTable hashTable(this->maxRowsPerBlock * (BLOCK_COUNT - 2));
+  ofstream fout(this->sourceFileName, ios::app);
+  for (int pageCounter = 0; pageCounter < table->blockCount; pageCounter++) {
+    vector<vector<int>> rows = table->readPage(pageCounter);
+    for (vector<int> &row : rows) {
+      int key = HashTable::hashRow(row);
+      int entry = hashTable.find(key);
+      while (entry != -1 && distinctRows[entry] != row)
+        entry = hashTable.next(entry);
+      if (entry != -1)
+        continue;
+      hashTable.insert(key, distinctRows.size());
+      distinctRows.push_back(row);
+      this->writeRow<int>(row, fout);
+    }
+  }
+  fout.close();
+
+  this->blockify();
+  this->inheritSortOrder(table);
+}
+
+/**
+ * @brief Fills this table with the distinct rows of table when table is
+ * sorted on all its columns, so that equal rows are next to each other. A
+ * row is dropped when it equals the row before it; table is read once and
+ * nothing but the last row is kept in memory.
+ *
+ * @param table
+ */
+void Table::streamDistinct(Table* table){
+  logger.log("Table::streamDistinct");
+
+  vector<int> lastRow;
+  ofstream fout(this->sourceFileName, ios::app);
+  for (int pageCounter = 0; pageCounter < table->blockCount; pageCounter++) {
+    vector<vector<int>> rows = table->readPage(pageCounter);
+    for (vector<int> &row : rows) {
+      if (row == lastRow)
+        continue;
+      this->writeRow<int>(row, fout);
+      lastRow = row;
+    }
+  }
+  fout.close();
+
+  this->blockify();
+  this->inheritSortOrder(table);
+}
+
+/**
+ * @brief Fills this table with the distinct rows of table using the external
+ * sort. table is sorted on all its columns; duplicates are dropped within
+ * each run and again while the runs are merged, so no separate pass is needed
+ * to remove them. Rows are output in ascending order.
+ *
+ * @param table
+ */
+void Table::sortDistinct(Table* table){
+  logger.log("Table::sortDistinct");
+
+  if (table->blockCount == 0) {
+    this->blockify();
+    return;
+  }
+  vector<int> sortingStrategy(table->columnCount, ASC);
+  vector<Table*> sortedRuns = table->externalSort(table->columns, sortingStrategy,
+                                                  this->tableName, true);
+
+  ofstream fout(this->sourceFileName, ios::app);
+  for (Table* sortedRun : sortedRuns) {
+    for (int pageCounter = 0; pageCounter < sortedRun->blockCount; pageCounter++) {
+      vector<vector<int>> rows = sortedRun->readPage(pageCounter);
+      for (vector<int> &row : rows)
+        this->writeRow<int>(row, fout);
+    }
+    tableCatalogue.deleteTable(sortedRun->tableName);
+  }
+  fout.close();
+
+  this->blockify();
+  this->sortedColumns = this->columns;
+  this->sortedStrategy = sortingStrategy;
+}
+
+/**
+ * @brief Fills this table with the first limit rows of table in the order of
+ * columnName, as sortTable would arrange them (rows with equal values keep
+ * their order). table is scanned once while a heap keeps the best limit rows
+ * seen so far, its top being the row that would be dropped next, so the
+ * limit rows have to fit in memory.
+ *
+ * @param table
+ * @param columnName
+ * @param sortingStrategy ASC or DESC
+ * @param limit
+ */
+void Table::topRows(Table* table, string columnName, int sortingStrategy, long long limit){
+  logger.log("Table::topRows");
+
+  int columnIndex = table->getColumnIndex(columnName);
+  // ((value, position), row) where value is negated for DESC, so that the
+  // greatest entry is always the worst row
+  priority_queue<pair<pair<long long, long long>, vector<int>>> heap;
+  long long position = 0;
+  for (int pageCounter = 0; pageCounter < table->blockCount; pageCounter++) {
+    vector<vector<int>> rows = table->readPage(pageCounter);
+    for (vector<int> &row : rows) {
+      long long value = sortingStrategy == ASC ? row[columnIndex] : -(long long)row[columnIndex];
+      pair<long long, long long> order = {value, position++};
+      if ((long long)heap.size() < limit)
+        heap.push({order, row});
+      else if (order < heap.top().first) {
+        heap.pop();
+        heap.push({order, row});
+      }
+    }
+  }
+
+  vector<vector<int>> resultantRows(heap.size());
+  for (int rowCounter = (int)heap.size() - 1; rowCounter >= 0; rowCounter--) {
+    resultantRows[rowCounter] = heap.top().second;
+    heap.pop();
+  }
+  ofstream fout(this->sourceFileName, ios::app);
+  for (vector<int> &row : resultantRows)
+    this->writeRow<int>(row, fout);
+  fout.close();
+  this->blockify();
+  this->sortedColumns = {columnName};
+  this->sortedStrategy = {sortingStrategy};
+}
+
+/**
+ * @brief Drops every row after the first rowLimit rows of the table. Pages
+ * that hold no remaining rows are deleted and the last remaining page is
+ * rewritten. Column statistics are left as they were and remain upper bounds.
+ *
+ * @param rowLimit
+ */
+void Table::truncate(long long rowLimit){
+  logger.log("Table::truncate");
+
+  while (this->blockCount > 0 && this->rowCount - this->rowsPerBlockCount.back() >= rowLimit) {
+    this->blockCount--;
+    this->rowCount -= this->rowsPerBlockCount.back();
+    this->rowsPerBlockCount.pop_back();
+    bufferManager.removeFromPool(this->tableName, this->blockCount);
+    bufferManager.deleteFile(this->tableName, this->blockCount);
+  }
+  if (this->rowCount <= rowLimit)
+    return;
+  vector<vector<int>> rows = this->readPage(this->blockCount - 1);
+  rows.resize(rows.size() - (this->rowCount - rowLimit));
+  bufferManager.writePage(this->tableName, this->blockCount - 1, rows, rows.size());
+  bufferManager.removeFromPool(this->tableName, this->blockCount - 1);
+  this->rowsPerBlockCount.back() = rows.size();
+  this->rowCount = rowLimit;
+}
+
+/**
+ * @brief Copy contents from original table to new table, keeping its order.
+ * With a rowLimit other than -1 only the first rowLimit rows are copied and
+ * the rest of table is not read.
+ *
+ * @param table
+ * @param rowLimit
+ */
+void Table::copy(Table* table, long long rowLimit){
+  logger.log("Table::copy");
+
   Cursor cursor = table->getCursor();
-  vector<int> row = cursor.getNext();
+  vector<int> row = rowLimit == 0 ? vector<int>() : cursor.getNext();
 
   while(!row.empty()){
-    int val = 0;
-    if(aggFunc1 == "MAX") val = row[1];
-    else if(aggFunc1 == "MIN") val = row[2];
-    else if(aggFunc1 == "SUM") val = row[3];
-    else if(aggFunc1 == "COUNT") val = row[4];
-    else  val = row[3]/row[4];
-    
-    if(evaluateBinOp(val, attrValue, mp[binaryOp])){
-      vector<int> resultantRow;
-      resultantRow.push_back(row[0]);
-
-      if(aggFunc2 == "MAX") resultantRow.push_back(row[1]);
-      else if(aggFunc2 == "MIN") resultantRow.push_back(row[2]);
-      else if(aggFunc2 == "SUM") resultantRow.push_back(row[3]);
-      else if(aggFunc2 == "COUNT") resultantRow.push_back(row[4]);
-      else  resultantRow.push_back(row[3]/row[4]);
-
-      this->writeRow<int>(resultantRow);
+    this->writeRow<int>(row);
+    if (--rowLimit == 0)
+      break;
+    row = cursor.getNext();
+  }
+
+  this->blockify();
+  this->inheritSortOrder(table);
+
+  // delete csv file
+  string filename = "../data/temp/" + this->tableName + ".csv";
+  logger.log("csv file to be deleted: " + filename);
+  if(remove(filename.c_str()) == 0)
+    logger.log("csv file deleted successfully");
+  else
+    logger.log("csv file deleteion unsuccessful");
+}
+
+/**
+ * @brief Fills this table with the groups of table on groupingColumnNames
+ * that satisfy the HAVING condition, together with the aggregates listed in
+ * returnFunctions and returnColumnNames. The condition is skipped when
+ * binaryop is NO_BINOP_CLAUSE. MAX, MIN and SUM of every aggregated column
+ * and the COUNT of every group are computed in a single scan of table using a
+ * hash table on the grouping key, and AVG is derived from SUM and COUNT. SUM
+ * and COUNT are accumulated in 64 bits.
+ *
+ * <p>
+ * At most BLOCK_COUNT - 2 blocks of groups are kept in memory. When a new
+ * group does not fit, the partial groups are spilled to temporary tables
+ * partitioned on the grouping key and the scan goes on with an empty hash
+ * table. The partitions are then aggregated in turn, with a different
+ * partitioning seed at every level, combining the partial groups of the same
+ * key. Groups are output in ascending order of the grouping key.
+ * </p>
+ *
+ * <p>
+ * When the distinct values of the grouping columns show that the groups fit
+ * in memory more than once, the scan is split instead between as many threads
+ * as copies fit, working on disjoint ranges of pages. Each thread aggregates its
+ * range into a hash table of its own and divides the groups by hash of the
+ * key, and each partition is then merged by one thread.
+ * </p>
+ *
+ * <p>
+ * When table is already sorted ascending on the grouping columns, every group
+ * is aggregated and output as soon as the key changes, in a single scan with
+ * one group in memory.
+ * </p>
+ *
+ * @param table
+ * @param groupingColumnNames
+ * @param havingFunction
+ * @param havingColumnName
+ * @param binaryop
+ * @param havingValue
+ * @param returnFunctions
+ * @param returnColumnNames
+ * @return false if a returned aggregate does not fit in an int, in which case
+ * the table is left incomplete
+ */
+bool Table::groupBy(Table* table, vector<string> groupingColumnNames,
+                    string havingFunction, string havingColumnName, int binaryop,
+                    long long havingValue, vector<string> returnFunctions,
+                    vector<string> returnColumnNames){
+  logger.log("Table::groupBy");
+  const int MAX_PARTITION_DEPTH = 3;
+  const uint MIN_PAGES_PER_THREAD = 4;
+  uint frames = BLOCK_COUNT - 2;
+  uint partitionCount = frames;
+  uint keyCount = groupingColumnNames.size();
+
+  // columns whose MAX, MIN and SUM are kept, in order of first use
+  vector<string> aggregateColumnNames;
+  auto addAggregate = [&](string &function, string &columnName) {
+    if (function != "COUNT" &&
+        find(aggregateColumnNames.begin(), aggregateColumnNames.end(), columnName) ==
+            aggregateColumnNames.end())
+      aggregateColumnNames.push_back(columnName);
+  };
+  if (binaryop != NO_BINOP_CLAUSE)
+    addAggregate(havingFunction, havingColumnName);
+  for (int aggregateCounter = 0; aggregateCounter < returnFunctions.size(); aggregateCounter++)
+    addAggregate(returnFunctions[aggregateCounter], returnColumnNames[aggregateCounter]);
+  uint aggregateCount = aggregateColumnNames.size();
+  vector<int> groupIndices, aggregateIndices;
+  for (string &columnName : groupingColumnNames)
+    groupIndices.push_back(table->getColumnIndex(columnName));
+  for (string &columnName : aggregateColumnNames)
+    aggregateIndices.push_back(table->getColumnIndex(columnName));
+
+  // in memory a group is {keys..., (MAX, MIN, SUM) per column..., COUNT}. In
+  // the spilled partitions SUM and COUNT take two ints each, high word first
+  vector<string> groupColumns = groupingColumnNames;
+  for (string &columnName : aggregateColumnNames)
+    for (string function : {"MAX", "MIN", "SUMHIGH", "SUMLOW"})
+      groupColumns.push_back(function + columnName);
+  groupColumns.push_back("COUNTHIGH");
+  groupColumns.push_back("COUNTLOW");
+  uint groupsPerBlock = (uint)((BLOCK_SIZE * 1000) / (sizeof(int) * groupColumns.size()));
+  uint maxGroups = frames * groupsPerBlock;
+  auto join64 = [](int high, int low) {
+    return (long long)(((unsigned long long)(uint)high << 32) | (uint)low);
+  };
+  auto toRow = [&](vector<long long> &group) {
+    vector<int> row(group.begin(), group.begin() + keyCount);
+    for (uint aggregate = 0; aggregate < aggregateCount; aggregate++) {
+      long long *values = &group[keyCount + 3 * aggregate];
+      row.insert(row.end(), {(int)values[0], (int)values[1], (int)(values[2] >> 32), (int)values[2]});
+    }
+    row.insert(row.end(), {(int)(group.back() >> 32), (int)group.back()});
+    return row;
+  };
+  auto fromRow = [&](vector<int> &row) {
+    vector<long long> group(row.begin(), row.begin() + keyCount);
+    for (uint aggregate = 0; aggregate < aggregateCount; aggregate++) {
+      int *values = &row[keyCount + 4 * aggregate];
+      group.insert(group.end(), {values[0], values[1], join64(values[2], values[3])});
     }
+    group.push_back(join64(row[row.size() - 2], row.back()));
+    return group;
+  };
+  auto aggregateOf = [&](vector<long long> &group, string &function, string &columnName) {
+    if (function == "COUNT")
+      return group.back();
+    uint aggregate = find(aggregateColumnNames.begin(), aggregateColumnNames.end(), columnName) -
+                     aggregateColumnNames.begin();
+    long long *values = &group[keyCount + 3 * aggregate];
+    if (function == "MAX")
+      return values[0];
+    if (function == "MIN")
+      return values[1];
+    if (function == "SUM")
+      return values[2];
+    return values[2] / group.back();
+  };
 
-    row = cursor.getNext();
+  auto hashOf = [&](vector<int> &keys) {
+    return keyCount == 1 ? keys[0] : HashTable::hashRow(keys);
+  };
+  // returns the group of keys or -1, key being hashOf(keys)
+  auto findGroup = [&](vector<vector<long long>> &groups, HashTable &hashTable,
+                       vector<int> &keys, int key) {
+    int entry = hashTable.find(key);
+    while (entry != -1 && !equal(keys.begin(), keys.end(), groups[entry].begin()))
+      entry = hashTable.next(entry);
+    return entry;
+  };
+  auto newGroup = [&](vector<int> &keys, vector<int> &row) {
+    vector<long long> group(keys.begin(), keys.end());
+    for (int index : aggregateIndices)
+      group.insert(group.end(), {row[index], row[index], row[index]});
+    group.push_back(1);
+    return group;
+  };
+  auto addRow = [&](vector<long long> &group, vector<int> &row) {
+    for (uint aggregate = 0; aggregate < aggregateCount; aggregate++) {
+      uint offset = keyCount + 3 * aggregate;
+      int value = row[aggregateIndices[aggregate]];
+      group[offset] = max(group[offset], (long long)value);
+      group[offset + 1] = min(group[offset + 1], (long long)value);
+      group[offset + 2] += value;
+    }
+    group.back()++;
+  };
+  auto addGroup = [&](vector<long long> &group, vector<long long> &partialGroup) {
+    for (uint aggregate = 0; aggregate < aggregateCount; aggregate++) {
+      uint offset = keyCount + 3 * aggregate;
+      group[offset] = max(group[offset], partialGroup[offset]);
+      group[offset + 1] = min(group[offset + 1], partialGroup[offset + 1]);
+      group[offset + 2] += partialGroup[offset + 2];
+    }
+    group.back() += partialGroup.back();
+  };
+
+  ofstream fout(this->sourceFileName, ios::app);
+  bool inRange = true;
+  vector<int> keyIndices(keyCount);
+  iota(keyIndices.begin(), keyIndices.end(), 0);
+  vector<int> resultantRow;
+  auto emitGroup = [&](vector<long long> &group) {
+    if (binaryop != NO_BINOP_CLAUSE &&
+        !evaluateBinOp(aggregateOf(group, havingFunction, havingColumnName), havingValue,
+                       (BinaryOperator)binaryop))
+      return;
+    resultantRow.assign(group.begin(), group.begin() + keyCount);
+    for (int aggregateCounter = 0; aggregateCounter < returnFunctions.size(); aggregateCounter++) {
+      long long value = aggregateOf(group, returnFunctions[aggregateCounter],
+                                    returnColumnNames[aggregateCounter]);
+      if (value < INT_MIN || value > INT_MAX)
+        inRange = false;
+      resultantRow.push_back((int)value);
+    }
+    if (inRange)
+      this->writeRow<int>(resultantRow, fout);
+  };
+  auto emitGroups = [&](vector<vector<long long>> &groups) {
+    radixSortRows(groups, keyIndices, vector<int>(keyCount, ASC));
+    for (vector<long long> &group : groups) {
+      emitGroup(group);
+      if (!inRange)
+        return;
+    }
+  };
+  // groups are output in ascending order of the grouping key
+  auto finish = [&]() {
+    fout.close();
+    if (!inRange)
+      return false;
+    this->blockify();
+    this->sortedColumns = groupingColumnNames;
+    this->sortedStrategy = vector<int>(keyCount, ASC);
+    return true;
+  };
+
+  // rows of one group are next to each other in a table sorted on the
+  // grouping key, so each group is complete when the key changes
+  if (table->isSortedOn(groupingColumnNames, vector<int>(keyCount, ASC))) {
+    logger.log("Table::groupBy: Streaming over the sort order");
+    vector<long long> group;
+    vector<int> keys(keyCount);
+    for (int pageCounter = 0; pageCounter < table->blockCount && inRange; pageCounter++) {
+      vector<vector<int>> rows = table->readPage(pageCounter);
+      for (vector<int> &row : rows) {
+        for (uint keyCounter = 0; keyCounter < keyCount; keyCounter++)
+          keys[keyCounter] = row[groupIndices[keyCounter]];
+        if (!group.empty() && equal(keys.begin(), keys.end(), group.begin())) {
+          addRow(group, row);
+          continue;
+        }
+        if (!group.empty())
+          emitGroup(group);
+        group = newGroup(keys, row);
+      }
+    }
+    if (!group.empty() && inRange)
+      emitGroup(group);
+    return finish();
   }
 
+  // the number of groups is at most the product of the distinct value counts
+  // of the grouping columns
+  long long groupBound = table->rowCount;
+  if (table->distinctValuesPerColumnCount.size() == table->columnCount) {
+    long long product = 1;
+    for (int index : groupIndices) {
+      product *= table->distinctValuesPerColumnCount[index];
+      if (product >= groupBound)
+        break;
+    }
+    groupBound = min(groupBound, product);
+  }
+  uint threadCount = min(max(thread::hardware_concurrency(), 1u),
+                         table->blockCount / MIN_PAGES_PER_THREAD);
+  threadCount = min((long long)threadCount, maxGroups / max(groupBound, 1LL));
+  if (threadCount > 1) {
+    logger.log("Table::groupBy: Aggregating with " + to_string(threadCount) + " threads");
+    // groups of every thread, split by the partition of their key
+    vector<vector<vector<vector<long long>>>> threadGroups(
+        threadCount, vector<vector<vector<long long>>>(threadCount));
+    vector<thread> workers;
+    for (uint worker = 0; worker < threadCount; worker++)
+      workers.emplace_back([&, worker]() {
+        vector<vector<long long>> groups;
+        HashTable hashTable(groupBound);
+        vector<int> keys(keyCount);
+        for (uint pageCounter = table->blockCount * worker / threadCount;
+             pageCounter < table->blockCount * (worker + 1) / threadCount; pageCounter++) {
+          vector<vector<int>> rows = table->readPage(pageCounter);
+          for (vector<int> &row : rows) {
+            for (uint keyCounter = 0; keyCounter < keyCount; keyCounter++)
+              keys[keyCounter] = row[groupIndices[keyCounter]];
+            int key = hashOf(keys);
+            int entry = findGroup(groups, hashTable, keys, key);
+            if (entry != -1) {
+              addRow(groups[entry], row);
+              continue;
+            }
+            hashTable.insert(key, groups.size());
+            groups.push_back(newGroup(keys, row));
+          }
+        }
+        for (vector<long long> &group : groups) {
+          keys.assign(group.begin(), group.begin() + keyCount);
+          threadGroups[worker][HashTable::partitionOf(hashOf(keys), 0, threadCount)].push_back(group);
+        }
+      });
+    for (thread &worker : workers)
+      worker.join();
+    workers.clear();
+
+    vector<vector<vector<long long>>> partitionGroups(threadCount);
+    for (uint partition = 0; partition < threadCount; partition++)
+      workers.emplace_back([&, partition]() {
+        vector<vector<long long>> &groups = partitionGroups[partition];
+        HashTable hashTable(groupBound / threadCount + 1);
+        vector<int> keys(keyCount);
+        for (uint worker = 0; worker < threadCount; worker++)
+          for (vector<long long> &partialGroup : threadGroups[worker][partition]) {
+            keys.assign(partialGroup.begin(), partialGroup.begin() + keyCount);
+            int key = hashOf(keys);
+            int entry = findGroup(groups, hashTable, keys, key);
+            if (entry != -1) {
+              addGroup(groups[entry], partialGroup);
+              continue;
+            }
+            hashTable.insert(key, groups.size());
+            groups.push_back(partialGroup);
+          }
+      });
+    for (thread &worker : workers)
+      worker.join();
+
+    vector<vector<long long>> groups;
+    for (vector<vector<long long>> &partition : partitionGroups)
+      groups.insert(groups.end(), partition.begin(), partition.end());
+    emitGroups(groups);
+    return finish();
+  }
+
+  bool ordered = true;
+  // tables still to be aggregated with their partitioning depth; only table
+  // itself holds source rows, the partitions hold partial groups
+  vector<pair<Table*, int>> pending = {{table, 0}};
+  while (!pending.empty()) {
+    Table* input = pending.back().first;
+    int depth = pending.back().second;
+    pending.pop_back();
+    bool partial = input != table;
+    if (!inRange) {
+      tableCatalogue.deleteTable(input->tableName);
+      continue;
+    }
+
+    vector<vector<long long>> groups;
+    HashTable hashTable(min((long long)maxGroups, input->rowCount));
+    vector<Table*> partitions(partitionCount, NULL);
+    vector<int> keys(keyCount);
+    auto spill = [&]() {
+      vector<vector<vector<int>>> partitionRows(partitionCount);
+      for (vector<long long> &group : groups) {
+        vector<int> row = toRow(group);
+        vector<int> groupKeys(row.begin(), row.begin() + keyCount);
+        partitionRows[HashTable::partitionOf(hashOf(groupKeys), depth, partitionCount)].push_back(row);
+      }
+      for (uint partition = 0; partition < partitionCount; partition++) {
+        vector<vector<int>> &rows = partitionRows[partition];
+        if (rows.empty())
+          continue;
+        if (!partitions[partition]) {
+          partitions[partition] = new Table(this->tableName + "_gb" + to_string(depth) +
+                                            "_" + to_string(partition), groupColumns);
+          tableCatalogue.insertTable(partitions[partition]);
+        }
+        for (uint rowCounter = 0; rowCounter < rows.size(); rowCounter += groupsPerBlock) {
+          vector<vector<int>> page(rows.begin() + rowCounter,
+                                   rows.begin() + min((uint)rows.size(), rowCounter + groupsPerBlock));
+          partitions[partition]->appendPage(page);
+        }
+      }
+      groups.clear();
+      hashTable = HashTable(maxGroups);
+    };
+
+    for (int pageCounter = 0; pageCounter < input->blockCount; pageCounter++) {
+      vector<vector<int>> rows = input->readPage(pageCounter);
+      for (vector<int> &row : rows) {
+        for (uint keyCounter = 0; keyCounter < keyCount; keyCounter++)
+          keys[keyCounter] = partial ? row[keyCounter] : row[groupIndices[keyCounter]];
+        int key = hashOf(keys);
+        int entry = findGroup(groups, hashTable, keys, key);
+        if (entry != -1) {
+          if (partial) {
+            vector<long long> partialGroup = fromRow(row);
+            addGroup(groups[entry], partialGroup);
+          } else {
+            addRow(groups[entry], row);
+          }
+          continue;
+        }
+        if (groups.size() == maxGroups && depth < MAX_PARTITION_DEPTH) {
+          logger.log("Table::groupBy: Spilling groups at depth " + to_string(depth));
+          spill();
+        }
+        hashTable.insert(key, groups.size());
+        groups.push_back(partial ? fromRow(row) : newGroup(keys, row));
+      }
+    }
+    if (partial)
+      tableCatalogue.deleteTable(input->tableName);
+
+    if (count(partitions.begin(), partitions.end(), (Table*)NULL) != partitionCount) {
+      spill();
+      for (uint partition = 0; partition < partitionCount; partition++)
+        if (partitions[partition])
+          pending.push_back({partitions[partition], depth + 1});
+      ordered = false;
+      continue;
+    }
+    emitGroups(groups);
+  }
+  fout.close();
+  if (!inRange)
+    return false;
   this->blockify();
+
+  // partitions cover disjoint key ranges only by hash, so their outputs have
+  // to be put back in key order
+  if (!ordered)
+    this->sortTable(groupingColumnNames, vector<int>(keyCount, ASC));
+  this->sortedColumns = groupingColumnNames;
+  this->sortedStrategy = vector<int>(keyCount, ASC);
+  return true;
+}
+
+/**
+ * @brief Name under which the pages of the index of this table are stored.
+ * It holds the position of the indexed column rather than its name, so that
+ * RENAME leaves the files where they are.
+ *
+ * @return string
+ */
+string Table::indexName() {
+  return this->tableName + "_" + to_string(this->getColumnIndex(this->indexedColumn));
+}
+
+/**
+ * @brief Indexes the table on columnName, replacing the index it may already
+ * have, or just removes that index if indexingStrategy is NOTHING. A BITMAP
+ * index is kept apart from the BTREE or HASH index, so the table may have one
+ * of those and bitmap indexes on any number of columns, and NOTHING removes
+ * the bitmap index of columnName if there is one. BLOOM filters of the pages
+ * on columnName are table metadata, see buildBloomFilters, and NOTHING
+ * removes them too when the column has no bitmap index. The
+ * entries {key, page, slot} of all the rows are written to a temporary table
+ * and sorted with sortTable, which keeps rows with equal keys in table order.
+ * For a BTREE they are sorted on key and bulk loaded into the tree. For a
+ * HASH the index is first sized for the rows, every entry is prefixed with
+ * the bucket of its key and the entries are sorted on bucket, so that the
+ * buckets can be written one after the other. The entries of a BTREE also
+ * carry the values of includedColumns, see indexOnlyScan.
+ *
+ * @param columnName
+ * @param indexingStrategy
+ * @param includedColumns columns whose values the leaves of a BTREE carry
+ */
+void Table::buildIndex(string columnName, IndexingStrategy indexingStrategy,
+                       vector<string> includedColumns) {
+  logger.log("Table::buildIndex");
+  int columnIndex = this->getColumnIndex(columnName);
+  if (indexingStrategy == BLOOM || (indexingStrategy == NOTHING && this->bloomFilterIndex(columnName) != -1
+                                    && !this->isBitmapIndexed(columnName))) {
+    this->dropBloomFilters(columnName);
+    if (indexingStrategy == BLOOM)
+      this->buildBloomFilters(columnName);
+    return;
+  }
+  if (indexingStrategy == BITMAP || (indexingStrategy == NOTHING && this->isBitmapIndexed(columnName))) {
+    this->dropBitmapIndex(columnName);
+    if (indexingStrategy == BITMAP) {
+      BitmapIndex(this->bitmapIndexName(columnName)).build(this, columnIndex);
+      this->bitmapIndexedColumns.push_back(columnName);
+    }
+    return;
+  }
+  this->dropIndex();
+  if (indexingStrategy == NOTHING)
+    return;
+  this->indexedColumn = columnName;
+  HashIndex hashIndex(this->indexName());
+  vector<string> entryColumns = {"key", "page", "slot"};
+  vector<int> includedIndices;
+  for (string &includedColumn : includedColumns) {
+    entryColumns.push_back(includedColumn);
+    includedIndices.push_back(this->getColumnIndex(includedColumn));
+  }
+  if (indexingStrategy == HASH) {
+    hashIndex.presize(this->rowCount);
+    entryColumns.insert(entryColumns.begin(), "bucket");
+  }
+
+  Table *entries = new Table(this->indexName() + "_entries", entryColumns);
+  tableCatalogue.insertTable(entries);
+  vector<vector<int>> rowsInPage;
+  for (int pageCounter = 0; pageCounter < this->blockCount; pageCounter++) {
+    vector<vector<int>> rows = this->readPage(pageCounter);
+    for (int slot = 0; slot < (int)rows.size(); slot++) {
+      int key = rows[slot][columnIndex];
+      if (indexingStrategy == HASH) {
+        rowsInPage.push_back({(int)hashIndex.bucketOf(key), key, pageCounter, slot});
+      } else {
+        rowsInPage.push_back({key, pageCounter, slot});
+        for (int index : includedIndices)
+          rowsInPage.back().push_back(rows[slot][index]);
+      }
+      if (rowsInPage.size() == entries->maxRowsPerBlock) {
+        entries->appendPage(rowsInPage);
+        rowsInPage.clear();
+      }
+    }
+  }
+  if (!rowsInPage.empty())
+    entries->appendPage(rowsInPage);
+  entries->sortTable({entryColumns[0]}, {ASC});
+  if (indexingStrategy == HASH)
+    hashIndex.bulkLoad(entries);
+  else
+    BTree(this->indexName()).bulkLoad(entries);
+  tableCatalogue.deleteTable(entries->tableName);
+
+  this->indexed = true;
+  this->indexingStrategy = indexingStrategy;
+  this->includedColumns = includedColumns;
+}
+
+/**
+ * @brief Deletes the BTREE or HASH index of the table, if it has one.
+ */
+void Table::dropIndex() {
+  logger.log("Table::dropIndex");
+  if (!this->indexed)
+    return;
+  if (this->indexingStrategy == BTREE)
+    BTree(this->indexName()).drop();
+  else if (this->indexingStrategy == HASH)
+    HashIndex(this->indexName()).drop();
+  this->indexed = false;
+  this->indexedColumn = "";
+  this->indexingStrategy = NOTHING;
+  this->includedColumns.clear();
+}
+
+/**
+ * @brief Returns the location {page, slot} of every row whose value of the
+ * indexed column lies in [lowKey, highKey], read from the index. A hash index
+ * can only be used when lowKey is highKey.
+ *
+ * @param lowKey
+ * @param highKey
+ * @return vector<pair<int, int>>
+ */
+vector<pair<int, int>> Table::indexLookup(long long lowKey, long long highKey) {
+  logger.log("Table::indexLookup");
+  if (this->indexingStrategy == HASH)
+    return HashIndex(this->indexName()).find(lowKey);
+  return BTree(this->indexName()).findRange(lowKey, highKey);
+}
+
+/**
+ * @brief Returns the locations {page, slot} of the rows of every key of keys,
+ * read from the index. The keys must be sorted and distinct.
+ *
+ * @param keys
+ * @return vector<vector<pair<int, int>>> locations of keys[i] at i
+ */
+vector<vector<pair<int, int>>> Table::indexLookup(const vector<int> &keys) {
+  logger.log("Table::indexLookup");
+  if (this->indexingStrategy == HASH)
+    return HashIndex(this->indexName()).findKeys(keys);
+  return BTree(this->indexName()).findKeys(keys);
+}
+
+/**
+ * @brief Checks if the leaves of the BTREE index hold every column of
+ * columnNames, as the key or an included column.
+ *
+ * @param columnNames
+ * @return true if columnNames can be read from the index alone
+ */
+bool Table::indexCovers(vector<string> columnNames) {
+  logger.log("Table::indexCovers");
+  if (!this->indexed || this->indexingStrategy != BTREE)
+    return false;
+  for (string &columnName : columnNames)
+    if (columnName != this->indexedColumn &&
+        find(this->includedColumns.begin(), this->includedColumns.end(), columnName) ==
+            this->includedColumns.end())
+      return false;
+  return true;
+}
+
+/**
+ * @brief Returns the number of leaves of the BTREE index that hold the keys
+ * in [lowKey, highKey], found without reading any leaf.
+ *
+ * @param lowKey
+ * @param highKey
+ * @return long long
+ */
+long long Table::indexLeafCount(long long lowKey, long long highKey) {
+  logger.log("Table::indexLeafCount");
+  return BTree(this->indexName()).rangeLeafCount(lowKey, highKey);
+}
+
+/**
+ * @brief Writes to this table the values of columnNames of every row of table
+ * whose indexed column lies in [lowKey, highKey], reading the leaves of the
+ * BTREE index of table and no page of table. The rows come out in key order,
+ * and in table order for equal keys.
+ *
+ * @param table
+ * @param columnNames columns covered by the index, see indexCovers
+ * @param lowKey
+ * @param highKey
+ */
+void Table::indexOnlyScan(Table* table, vector<string> columnNames, long long lowKey,
+                          long long highKey) {
+  logger.log("Table::indexOnlyScan");
+  vector<int> entryIndices;
+  for (string &columnName : columnNames)
+    entryIndices.push_back(columnName == table->indexedColumn
+        ? 0
+        : 3 + (find(table->includedColumns.begin(), table->includedColumns.end(), columnName) -
+               table->includedColumns.begin()));
+  vector<int> row(entryIndices.size());
+  ofstream fout(this->sourceFileName, ios::app);
+  BTree(table->indexName()).scanRange(lowKey, highKey, [&](vector<int> &entry) {
+    for (int columnCounter = 0; columnCounter < entryIndices.size(); columnCounter++)
+      row[columnCounter] = entry[entryIndices[columnCounter]];
+    this->writeRow<int>(row, fout);
+  });
+  fout.close();
+}
+
+/**
+ * @brief Name under which the pages of the bitmap index of columnName are
+ * stored, by position of the column as for indexName.
+ *
+ * @param columnName
+ * @return string
+ */
+string Table::bitmapIndexName(string columnName) {
+  return this->tableName + "_" + to_string(this->getColumnIndex(columnName)) + "_Bitmap";
+}
+
+bool Table::isBitmapIndexed(string columnName) {
+  return find(this->bitmapIndexedColumns.begin(), this->bitmapIndexedColumns.end(),
+              columnName) != this->bitmapIndexedColumns.end();
+}
+
+/**
+ * @brief Deletes the bitmap index of columnName, if it has one.
+ *
+ * @param columnName
+ */
+void Table::dropBitmapIndex(string columnName) {
+  logger.log("Table::dropBitmapIndex");
+  if (!this->isBitmapIndexed(columnName))
+    return;
+  BitmapIndex(this->bitmapIndexName(columnName)).drop();
+  this->bitmapIndexedColumns.erase(find(this->bitmapIndexedColumns.begin(),
+                                        this->bitmapIndexedColumns.end(), columnName));
+}
+
+/**
+ * @brief Deletes every index of the table.
+ */
+void Table::dropIndexes() {
+  logger.log("Table::dropIndexes");
+  this->dropIndex();
+  while (!this->bitmapIndexedColumns.empty())
+    this->dropBitmapIndex(this->bitmapIndexedColumns.back());
+}
+
+/**
+ * @brief Returns the bitmap of the rows, numbered from 0 in table order, whose
+ * value of columnName is value, read from the bitmap index of columnName.
+ *
+ * @param columnName
+ * @param value
+ * @return RoaringBitmap
+ */
+RoaringBitmap Table::bitmapLookup(string columnName, int value) {
+  logger.log("Table::bitmapLookup");
+  return BitmapIndex(this->bitmapIndexName(columnName)).find(value);
+}
+
+/**
+ * @brief Returns the position of columnName in bloomColumns, or -1 if the
+ * pages have no Bloom filter on it.
+ *
+ * @param columnName
+ * @return int
+ */
+int Table::bloomFilterIndex(string columnName) {
+  for (int filterCounter = 0; filterCounter < this->bloomColumns.size(); filterCounter++)
+    if (this->bloomColumns[filterCounter] == columnName)
+      return filterCounter;
+  return -1;
+}
+
+/**
+ * @brief Keeps a Bloom filter of the values of columnName for every page of
+ * the table, reading the pages once. From then on the filters are kept up to
+ * date by updateBloomFilters whenever a page is written.
+ *
+ * @param columnName
+ */
+void Table::buildBloomFilters(string columnName) {
+  logger.log("Table::buildBloomFilters");
+  this->bloomColumns.push_back(columnName);
+  this->bloomFilters.emplace_back();
+  for (int pageCounter = 0; pageCounter < this->blockCount; pageCounter++) {
+    vector<vector<int>> rows = this->readPage(pageCounter);
+    this->updateBloomFilters(pageCounter, rows, rows.size());
+  }
+}
+
+void Table::dropBloomFilters(string columnName) {
+  logger.log("Table::dropBloomFilters");
+  int filterIndex = this->bloomFilterIndex(columnName);
+  if (filterIndex == -1)
+    return;
+  this->bloomColumns.erase(this->bloomColumns.begin() + filterIndex);
+  this->bloomFilters.erase(this->bloomFilters.begin() + filterIndex);
+}
+
+/**
+ * @brief Rebuilds the Bloom filters of page pageIndex from the first rowCount
+ * of rows, the rows just written to it.
+ *
+ * @param pageIndex
+ * @param rows
+ * @param rowCount
+ */
+void Table::updateBloomFilters(int pageIndex, vector<vector<int>> &rows, int rowCount) {
+  this->bloomFilters.resize(this->bloomColumns.size());
+  for (int filterCounter = 0; filterCounter < this->bloomColumns.size(); filterCounter++) {
+    int columnIndex = this->getColumnIndex(this->bloomColumns[filterCounter]);
+    vector<BloomFilter> &filters = this->bloomFilters[filterCounter];
+    if (filters.size() <= pageIndex)
+      filters.resize(pageIndex + 1);
+    filters[pageIndex] = BloomFilter(rowCount);
+    for (int rowCounter = 0; rowCounter < rowCount; rowCounter++)
+      filters[pageIndex].insert(rows[rowCounter][columnIndex]);
+  }
+}
+
+/**
+ * @brief File recording the indexes of the table that are valid for its
+ * source file ../data/<tableName>.csv.
+ *
+ * @return string
+ */
+string Table::indexCatalogueName() {
+  return "../data/index/" + this->tableName + ".indexes";
+}
+
+/**
+ * @brief Writes the index catalogue of the table: the size and modification
+ * time of ../data/<tableName>.csv, then a line {strategy, column position}
+ * for its BTREE or HASH index, each column it includes, every bitmap index
+ * and every column with Bloom filters. It is only written while the pages
+ * match the source file, and left alone otherwise: a table that does not
+ * match ../data/<tableName>.csv, like a derived table of the same name, has
+ * nothing to record for it. SORT removes the catalogue of a table that
+ * matched its file, see sortTable.
+ */
+void Table::saveIndexCatalogue() {
+  logger.log("Table::saveIndexCatalogue");
+  string catalogueName = this->indexCatalogueName();
+  string sourceName = "../data/" + this->tableName + ".csv";
+  struct stat buffer;
+  if (!this->pagesMatchSource)
+    return;
+  // indexes it listed that the table no longer has are deleted
+  this->removeIndexCatalogue();
+  if (stat(sourceName.c_str(), &buffer) != 0 ||
+      (!this->indexed && this->bitmapIndexedColumns.empty() && this->bloomColumns.empty()))
+    return;
+  ofstream fout(catalogueName, ios::out);
+  fout << buffer.st_size << " " << buffer.st_mtim.tv_sec << " " << buffer.st_mtim.tv_nsec << endl;
+  if (this->indexed)
+    fout << (this->indexingStrategy == HASH ? "HASH " : "BTREE ")
+         << this->getColumnIndex(this->indexedColumn) << endl;
+  for (string &columnName : this->includedColumns)
+    fout << "INCLUDE " << this->getColumnIndex(columnName) << endl;
+  for (string &columnName : this->bitmapIndexedColumns)
+    fout << "BITMAP " << this->getColumnIndex(columnName) << endl;
+  for (string &columnName : this->bloomColumns)
+    fout << "BLOOM " << this->getColumnIndex(columnName) << endl;
+  fout.close();
+}
+
+/**
+ * @brief Reopens the indexes recorded in the index catalogue when the source
+ * file is the one they were built for. Nothing of an index is read here: its
+ * pages are read through the buffer manager on its first lookup. The Bloom
+ * filters are kept in memory only, so their columns are set for blockify to
+ * build them while loading. Indexes of a source file that has changed since
+ * are deleted along with the catalogue.
+ */
+void Table::openIndexCatalogue() {
+  logger.log("Table::openIndexCatalogue");
+  string catalogueName = this->indexCatalogueName();
+  ifstream fin(catalogueName, ios::in);
+  if (!fin)
+    return;
+  long long size, seconds, nanoseconds;
+  fin >> size >> seconds >> nanoseconds;
+  struct stat buffer;
+  bool valid = stat(this->sourceFileName.c_str(), &buffer) == 0 && buffer.st_size == size &&
+               buffer.st_mtim.tv_sec == seconds && buffer.st_mtim.tv_nsec == nanoseconds;
+  auto exists = [](string indexName) {
+    struct stat buffer;
+    return stat(("../data/index/" + indexName + "_IndexPage0").c_str(), &buffer) == 0;
+  };
+  string strategy;
+  int columnIndex;
+  while (fin >> strategy >> columnIndex) {
+    if (columnIndex < 0 || columnIndex >= this->columnCount) {
+      valid = false;
+      continue;
+    }
+    string columnName = this->columns[columnIndex];
+    if (strategy == "BLOOM") {
+      this->bloomColumns.push_back(columnName);
+    } else if (strategy == "INCLUDE") {
+      this->includedColumns.push_back(columnName);
+    } else if (strategy == "BITMAP") {
+      if (exists(this->bitmapIndexName(columnName)))
+        this->bitmapIndexedColumns.push_back(columnName);
+      else
+        valid = false;
+    } else {
+      this->indexedColumn = columnName;
+      if (exists(this->indexName())) {
+        this->indexed = true;
+        this->indexingStrategy = strategy == "HASH" ? HASH : BTREE;
+      } else {
+        this->indexedColumn = "";
+        valid = false;
+      }
+    }
+  }
+  fin.close();
+  if (valid) {
+    logger.log("Table::openIndexCatalogue: Reopened the indexes of " + this->tableName);
+    return;
+  }
+  this->dropIndexes();
+  this->includedColumns.clear();
+  this->bloomColumns.clear();
+  this->removeIndexCatalogue();
+}
+
+/**
+ * @brief Removes the index catalogue of the table along with the files of
+ * the indexes it lists, except those of the indexes the table has now, which
+ * go by the same names.
+ */
+void Table::removeIndexCatalogue() {
+  logger.log("Table::removeIndexCatalogue");
+  string catalogueName = this->indexCatalogueName();
+  ifstream fin(catalogueName, ios::in);
+  if (!fin)
+    return;
+  unordered_set<string> liveIndexNames;
+  if (this->indexed)
+    liveIndexNames.insert(this->indexName());
+  for (string &columnName : this->bitmapIndexedColumns)
+    liveIndexNames.insert(this->bitmapIndexName(columnName));
+  long long size, seconds, nanoseconds;
+  fin >> size >> seconds >> nanoseconds;
+  string strategy;
+  int columnIndex;
+  while (fin >> strategy >> columnIndex) {
+    if (strategy != "BTREE" && strategy != "HASH" && strategy != "BITMAP")
+      continue;
+    string indexName = this->tableName + "_" + to_string(columnIndex);
+    if (strategy == "BITMAP")
+      indexName += "_Bitmap";
+    struct stat buffer;
+    if (liveIndexNames.count(indexName) ||
+        stat(("../data/index/" + indexName + "_IndexPage0").c_str(), &buffer) != 0)
+      continue;
+    if (strategy == "BTREE")
+      BTree(indexName).drop();
+    else if (strategy == "HASH")
+      HashIndex(indexName).drop();
+    else
+      BitmapIndex(indexName).drop();
+  }
+  fin.close();
+  remove(catalogueName.c_str());
 }
 
 // MATRIX IMPLEMENTATION
@@ -1,9 +1,11 @@
-#include "cursor.h"
+#include "hyperLogLog.h"
 
 enum IndexingStrategy
 {
     BTREE,
     HASH,
+    BITMAP,
+    BLOOM,
     NOTHING
 };
 
@@ -18,7 +20,7 @@ enum IndexingStrategy
  */
 class Table
 {
-    vector<unordered_set<int>> distinctValuesInColumns;
+    vector<HyperLogLog> distinctValueSketches;
 
 public:
     string sourceFileName = "";
@@ -34,10 +36,23 @@ public:
     bool indexed = false;
     string indexedColumn = "";
     IndexingStrategy indexingStrategy = NOTHING;
+    // columns whose values the leaves of the BTREE index carry besides the key
+    vector<string> includedColumns;
+    vector<string> bitmapIndexedColumns;
+    vector<string> bloomColumns;
+    // bloomFilters[c][p] holds the keys of page p in column bloomColumns[c]
+    vector<vector<BloomFilter>> bloomFilters;
+    // the rows are in order of sortedColumns[0] in sortedStrategy[0], then of
+    // sortedColumns[1] in sortedStrategy[1] and so on; empty if unknown
+    vector<string> sortedColumns;
+    vector<int> sortedStrategy;
+    // the pages hold the rows of ../data/<tableName>.csv in file order, so
+    // the index files remain valid for the next LOAD of that file
+    bool pagesMatchSource = false;
     
     bool extractColumnNames(string firstLine);
     bool blockify();
-    void updateStatistics(vector<int> row);
+    void updateStatistics(vector<int> &row);
     Table();
     Table(string tableName);
     Table(string tableName, vector<string> columns);
@@ -49,16 +64,71 @@ public:
     bool isPermanent();
     void getNextPage(Cursor *cursor);
     Cursor getCursor();
+    vector<vector<int>> readPage(int pageIndex);
     int getColumnIndex(string columnName);
     void unload();
     void sortTable(vector<string> sortColumnNames, vector<int>sortingStrategy);
+    void externalSortInPlace(vector<string> sortColumnNames, vector<int> sortingStrategy);
+    bool isSortedOn(vector<string> columnNames, vector<int> sortingStrategy);
+    void inheritSortOrder(Table* table);
+    static string sortKey(const vector<int> &row, const vector<int> &columnIndices,
+        const vector<int> &sortingStrategy);
+    template <typename T>
+    static void radixSortRows(vector<vector<T>> &rows, const vector<int> &columnIndices,
+        const vector<int> &sortingStrategy);
+    void sortRows(vector<vector<int>> &rows, vector<string> sortColumnNames,
+        vector<int> sortingStrategy);
+    vector<Table*> generateRuns(vector<string> sortColumnNames, vector<int> sortingStrategy,
+        string runPrefix, bool distinct, uint firstBlock, uint endBlock, uint heapBlocks,
+        vector<string> &pageKeys);
+    vector<Table*> mergeRuns(vector<string> sortColumnNames, vector<int> sortingStrategy,
+        string runPrefix, vector<Table*> runs, bool distinct, uint threadCount,
+        vector<string> &pageKeys);
     void merge(vector<string> sortColumnNames, vector<int> sortingStrategy, 
-        vector<Cursor> blockCursors, int round, int setCount);
-    void join(Table* table1, Table* table2, string col1, string col2, int binaryop);
-    void copy(Table* table);
-    void trim(Table* table);
-    void calculate(Table* table);
-    void groupBy(Table* table, string aggFunc1, string aggFunc2, int binaryOp, int attrValue);
+        vector<Table*> runs, Table* resultantTable, bool distinct, string lowKey, string highKey);
+    vector<Table*> externalSort(vector<string> sortColumnNames, vector<int> sortingStrategy,
+        string runPrefix, bool distinct);
+    void blockNestedLoopJoin(Table* table1, Table* table2, int index1, int index2, int binaryop);
+    void mergeJoin(Table* table1, Table* table2, string col1, string col2);
+    void bandJoin(Table* table1, Table* table2, string col1, string col2, int binaryop);
+    void hashJoin(Table* table1, Table* table2, string col1, string col2);
+    void indexNestedLoopJoin(Table* table1, Table* table2, string col1, string col2,
+        bool probeSecond);
+    void hashJoinPartitions(Table* table1, Table* table2, int index1, int index2,
+        int depth, ostream &fout);
+    void appendPage(vector<vector<int>> &rows);
+    void hashDistinct(Table* table);
+    void sortDistinct(Table* table);
+    void streamDistinct(Table* table);
+    void topRows(Table* table, string columnName, int sortingStrategy, long long limit);
+    void truncate(long long rowLimit);
+    void copy(Table* table, long long rowLimit = -1);
+    bool groupBy(Table* table, vector<string> groupingColumnNames, string havingFunction,
+        string havingColumnName, int binaryop, long long havingValue,
+        vector<string> returnFunctions, vector<string> returnColumnNames);
+    string indexName();
+    void buildIndex(string columnName, IndexingStrategy indexingStrategy,
+        vector<string> includedColumns = {});
+    void dropIndex();
+    vector<pair<int, int>> indexLookup(long long lowKey, long long highKey);
+    vector<vector<pair<int, int>>> indexLookup(const vector<int> &keys);
+    bool indexCovers(vector<string> columnNames);
+    long long indexLeafCount(long long lowKey, long long highKey);
+    void indexOnlyScan(Table* table, vector<string> columnNames, long long lowKey,
+        long long highKey);
+    string bitmapIndexName(string columnName);
+    bool isBitmapIndexed(string columnName);
+    void dropBitmapIndex(string columnName);
+    void dropIndexes();
+    RoaringBitmap bitmapLookup(string columnName, int value);
+    int bloomFilterIndex(string columnName);
+    void buildBloomFilters(string columnName);
+    void dropBloomFilters(string columnName);
+    void updateBloomFilters(int pageIndex, vector<vector<int>> &rows, int rowCount);
+    string indexCatalogueName();
+    void openIndexCatalogue();
+    void saveIndexCatalogue();
+    void removeIndexCatalogue();
 
   /**
  * @brief Static function that takes a vector of valued and prints them out in a
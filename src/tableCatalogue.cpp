@@ -2,17 +2,24 @@
 
 void TableCatalogue::insertTable(Table *table) {
   logger.log("TableCatalogue::~insertTable");
+  lock_guard<mutex> lock(this->catalogueMutex);
   this->tables[table->tableName] = table;
 }
 void TableCatalogue::deleteTable(string tableName) {
   logger.log("TableCatalogue::deleteTable");
-  this->tables[tableName]->unload();
-  delete this->tables[tableName];
-  this->tables.erase(tableName);
+  Table *table;
+  {
+    lock_guard<mutex> lock(this->catalogueMutex);
+    table = this->tables[tableName];
+    this->tables.erase(tableName);
+  }
+  table->unload();
+  delete table;
 }
 Table *TableCatalogue::getTable(string tableName) {
   logger.log("TableCatalogue::getTable");
   logger.log(tableName);
+  lock_guard<mutex> lock(this->catalogueMutex);
   Table *table = this->tables[tableName];
   if(!table) {
     logger.log(tableName + " NULL");
@@ -21,6 +28,7 @@ Table *TableCatalogue::getTable(string tableName) {
 }
 bool TableCatalogue::isTable(string tableName) {
   logger.log("TableCatalogue::isTable");
+  lock_guard<mutex> lock(this->catalogueMutex);
   if (this->tables.count(tableName))
     return true;
   return false;
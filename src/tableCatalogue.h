@@ -5,11 +5,17 @@
  * system. Everytime a table is added(removed) to(from) the system, it needs to
  * be added(removed) to(from) the tableCatalogue. 
  *
+ * <p>
+ * Threads of a parallel sort create tables and look them up at the same time,
+ * so the index is guarded by a mutex.
+ * </p>
+ *
  */
 class TableCatalogue
 {
 
     unordered_map<string, Table*> tables;
+    mutex catalogueMutex;
 
 public:
     TableCatalogue() {}